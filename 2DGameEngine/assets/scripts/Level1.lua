@@ -107,6 +107,22 @@ Level = {
         scale = 2.0
     },
 
+    ----------------------------------------------------
+    -- expected number of components of each type (the
+    -- 119 entities and room for the live projectiles), so
+    -- the component pools are allocated once at load
+    ----------------------------------------------------
+    pool_capacity = {
+        transform = 400,
+        sprite = 400,
+        rigidbody = 300,
+        boxcollider = 320,
+        projectile = 256,
+        health = 52,
+        projectile_emitter = 37,
+        animation = 15
+    },
+
     ----------------------------------------------------
     -- table to define entities and their components
     ----------------------------------------------------
@@ -144,7 +160,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 25,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "player",
+                    collides_with = { "projectiles" }
                 },
                 health = {
                     health_percentage = 100
@@ -271,7 +289,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 0, y = 7 }
+                    offset = { x = 0, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -303,7 +323,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 7, y = 10 }
+                    offset = { x = 7, y = 10 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -335,7 +357,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -367,7 +391,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -399,7 +425,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -431,7 +459,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -463,7 +493,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -495,7 +527,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 8, y = 6 }
+                    offset = { x = 8, y = 6 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -527,7 +561,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 8, y = 6 }
+                    offset = { x = 8, y = 6 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -576,7 +612,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 17,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -608,7 +646,9 @@ Level = {
                 boxcollider = {
                     width = 18,
                     height = 20,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -640,7 +680,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -672,7 +714,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 0, y = 7 }
+                    offset = { x = 0, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -704,7 +748,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 8, y = 4 }
+                    offset = { x = 8, y = 4 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -736,7 +782,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -768,7 +816,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -800,7 +850,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -832,7 +884,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -864,7 +918,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -896,7 +952,9 @@ Level = {
                 boxcollider = {
                     width = 22,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -928,7 +986,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -960,7 +1020,9 @@ Level = {
                 boxcollider = {
                     width = 19,
                     height = 20,
-                    offset = { x = 6, y = 7 }
+                    offset = { x = 6, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -992,7 +1054,9 @@ Level = {
                 boxcollider = {
                     width = 18,
                     height = 25,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1024,7 +1088,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 8, y = 4 }
+                    offset = { x = 8, y = 4 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1073,7 +1139,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1098,7 +1166,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1123,7 +1193,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1148,7 +1220,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1173,7 +1247,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1198,7 +1274,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1223,7 +1301,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1248,7 +1328,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1273,7 +1355,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1298,7 +1382,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 16,
-                    offset = { x = 3, y = 10 }
+                    offset = { x = 3, y = 10 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1323,7 +1409,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 16,
-                    offset = { x = 3, y = 10 }
+                    offset = { x = 3, y = 10 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1352,7 +1440,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1388,7 +1478,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1424,7 +1516,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1460,7 +1554,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1492,7 +1588,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1524,7 +1622,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1556,7 +1656,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1588,7 +1690,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1620,7 +1724,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1652,7 +1758,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2600,7 +2708,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 25,
-                    offset = { x = 5, y = 5}
+                    offset = { x = 5, y = 5},
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2632,7 +2742,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2661,7 +2773,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2693,7 +2807,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 30,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2787,7 +2903,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2849,7 +2967,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
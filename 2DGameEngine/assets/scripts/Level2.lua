@@ -90,6 +90,22 @@ Level = {
         scale = 2.0
     },
 
+    ----------------------------------------------------
+    -- expected number of components of each type (the
+    -- 106 entities and room for the live projectiles), so
+    -- the component pools are allocated once at load
+    ----------------------------------------------------
+    pool_capacity = {
+        transform = 400,
+        sprite = 400,
+        rigidbody = 300,
+        boxcollider = 300,
+        projectile = 256,
+        health = 44,
+        projectile_emitter = 36,
+        animation = 20
+    },
+
     ----------------------------------------------------
     -- table to define entities and their components
     ----------------------------------------------------
@@ -119,7 +135,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 25,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "player",
+                    collides_with = { "projectiles" }
                 },
                 health = {
                     health_percentage = 100
@@ -346,7 +364,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -382,7 +402,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -418,7 +440,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -454,7 +478,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -490,7 +516,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -526,7 +554,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -562,7 +592,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -599,7 +631,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -631,7 +665,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -663,7 +699,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -695,7 +733,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -727,7 +767,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -759,7 +801,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -791,7 +835,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -823,7 +869,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -855,7 +903,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -887,7 +937,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -919,7 +971,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -951,7 +1005,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -983,7 +1039,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1015,7 +1073,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1047,7 +1107,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1079,7 +1141,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1111,7 +1175,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -1158,7 +1224,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1189,7 +1257,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1268,7 +1338,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1299,7 +1371,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1394,7 +1468,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1425,7 +1501,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1456,7 +1534,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -1487,7 +1567,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    -- nothing reacts to its collisions
+                    collides_with = {}
                 },
                 health = {
                     health_percentage = 100
@@ -2235,7 +2317,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2267,7 +2351,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2299,7 +2385,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2331,7 +2419,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2363,7 +2453,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2392,7 +2484,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 25,
-                    offset = { x = 5, y = 5}
+                    offset = { x = 5, y = 5},
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2421,7 +2515,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2453,7 +2549,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2485,7 +2583,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2516,7 +2616,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -2569,7 +2671,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 24
+                    height = 24,
+                    layer = "enemies",
+                    collides_with = { "projectiles", "obstacles" }
                 },
                 health = {
                     health_percentage = 100
@@ -0,0 +1,28 @@
+#include "AssetHandle.h"
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+// Asset names are shared by every asset store, so a handle stays valid when the assets are reloaded
+static std::unordered_map<std::string, int> assetIndices[NUM_ASSET_TYPES];
+static std::vector<std::string> assetNames[NUM_ASSET_TYPES];
+
+// Components can be created on worker threads (e.g. through command buffers)
+static std::mutex assetNamesMutex;
+
+int GetAssetIndex(AssetType type, const std::string& assetId) {
+    std::lock_guard<std::mutex> lock(assetNamesMutex);
+    auto asset = assetIndices[type].emplace(assetId, static_cast<int>(assetNames[type].size()));
+    if (asset.second) {
+        assetNames[type].push_back(assetId);
+    }
+    return asset.first->second;
+}
+
+std::string GetAssetName(AssetType type, int index) {
+    std::lock_guard<std::mutex> lock(assetNamesMutex);
+    if (index < 0 || index >= static_cast<int>(assetNames[type].size())) {
+        return "";
+    }
+    return assetNames[type][index];
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+enum AssetType {
+	TEXTURE_ASSET,
+	FONT_ASSET,
+	AUDIO_ASSET,
+	NUM_ASSET_TYPES
+};
+
+// Returns the index of an asset name, interning it the first time it is referenced
+int GetAssetIndex(AssetType type, const std::string& assetId);
+std::string GetAssetName(AssetType type, int index);
+
+////////////////////////////////////////////////////////////////////////////////
+// AssetHandle
+////////////////////////////////////////////////////////////////////////////////
+// Typed index of an asset in the AssetStore. The asset id string is resolved
+// once, when the handle is created (e.g. when the level is loaded or a
+// component is built), so the lookups done every frame are array accesses.
+////////////////////////////////////////////////////////////////////////////////
+template <AssetType TType>
+struct AssetHandle {
+	int index;
+
+	AssetHandle() : index(-1) {}
+	AssetHandle(const std::string& assetId) : index(GetAssetIndex(TType, assetId)) {}
+	AssetHandle(const char* assetId) : index(GetAssetIndex(TType, assetId)) {}
+
+	bool IsValid() const { return index != -1; }
+	std::string GetName() const { return GetAssetName(TType, index); }
+
+	bool operator ==(const AssetHandle& other) const { return index == other.index; }
+	bool operator !=(const AssetHandle& other) const { return index != other.index; }
+};
+
+typedef AssetHandle<TEXTURE_ASSET> TextureHandle;
+typedef AssetHandle<FONT_ASSET> FontHandle;
+typedef AssetHandle<AUDIO_ASSET> AudioHandle;
+
+// Handles are only valid in the process that interned them, so snapshots store the names of the
+// handles used by an array of objects once, after the raw objects, and map them back on load
+template <typename TWriter, typename TObject, AssetType TType>
+void WriteAssetNames(TWriter& writer, const TObject* objects, int count, AssetHandle<TType> TObject::* handle) {
+	std::vector<int> indices;
+	for (int i = 0; i < count; i++) {
+		const int index = (objects[i].*handle).index;
+		if (index != -1 && std::find(indices.begin(), indices.end(), index) == indices.end()) {
+			indices.push_back(index);
+		}
+	}
+	writer.Write(static_cast<int32_t>(indices.size()));
+	for (auto index : indices) {
+		writer.Write(static_cast<int32_t>(index));
+		writer.WriteString(GetAssetName(TType, index));
+	}
+}
+
+template <typename TReader, typename TObject, AssetType TType>
+bool ReadAssetNames(TReader& reader, TObject* objects, int count, AssetHandle<TType> TObject::* handle) {
+	int32_t numNames;
+	if (!reader.Read(numNames) || numNames < 0) {
+		return false;
+	}
+	std::unordered_map<int, int> savedToLoadedIndex;
+	std::string name;
+	for (int i = 0; i < numNames; i++) {
+		int32_t savedIndex;
+		if (!reader.Read(savedIndex) || !reader.ReadString(name)) {
+			return false;
+		}
+		savedToLoadedIndex[savedIndex] = GetAssetIndex(TType, name);
+	}
+	for (int i = 0; i < count; i++) {
+		auto& index = (objects[i].*handle).index;
+		if (index != -1) {
+			auto loadedIndex = savedToLoadedIndex.find(index);
+			if (loadedIndex == savedToLoadedIndex.end()) {
+				return false;
+			}
+			index = loadedIndex->second;
+		}
+	}
+	return true;
+}
@@ -11,50 +11,89 @@ AssetStore::~AssetStore() {
     Logger::Log("AssetStore destructor called!");
 }
 
+// The interned asset names are kept, so handles created before still refer to the same ids
 void AssetStore::ClearAssets() {
     for (auto texture : textures) {
-        SDL_DestroyTexture(texture.second);
+        if (texture) {
+            SDL_DestroyTexture(texture);
+        }
     }
     textures.clear();
 
     for (auto font : fonts) {
-        TTF_CloseFont(font.second);
+        if (font) {
+            TTF_CloseFont(font);
+        }
     }
     fonts.clear();
 
     for (auto audio : audios) {
-        Mix_FreeChunk(audio.second);
+        if (audio) {
+            Mix_FreeChunk(audio);
+        }
     }
     audios.clear();
 }
 
-void AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath) {
+// Stores the asset at the index of its handle, growing the vector if needed
+template <typename TAsset>
+static TAsset*& GetSlot(std::vector<TAsset*>& assets, int index) {
+    if (index >= static_cast<int>(assets.size())) {
+        assets.resize(index + 1, nullptr);
+    }
+    return assets[index];
+}
+
+template <typename TAsset>
+static TAsset* GetAsset(const std::vector<TAsset*>& assets, int index) {
+    return index >= 0 && index < static_cast<int>(assets.size()) ? assets[index] : nullptr;
+}
+
+TextureHandle AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath) {
     SDL_Surface* surface = IMG_Load(filePath.c_str());
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
     SDL_FreeSurface(surface);
 
-    // Add the texture to the map
-    textures.emplace(assetId, texture);
+    // Add the texture to the store, an id that was already added keeps its first texture
+    TextureHandle handle(assetId);
+    SDL_Texture*& slot = GetSlot(textures, handle.index);
+    if (slot) {
+        SDL_DestroyTexture(texture);
+    }
+    else {
+        slot = texture;
+    }
 
-    Logger::Log("Texture added to the AssetStore with id " + assetId);
+    Logger::Log("Texture added to the AssetStore with id ", assetId);
+    return handle;
 }
 
-SDL_Texture* AssetStore::GetTexture(const std::string& assetId) {
-    return textures[assetId];
+SDL_Texture* AssetStore::GetTexture(TextureHandle handle) const {
+    return GetAsset(textures, handle.index);
 }
 
-void AssetStore::AddFont(const std::string& assetId, const std::string& filePath, int fontSize) {
-    fonts.emplace(assetId, TTF_OpenFont(filePath.c_str(), fontSize));
+FontHandle AssetStore::AddFont(const std::string& assetId, const std::string& filePath, int fontSize) {
+    FontHandle handle(assetId);
+    TTF_Font*& slot = GetSlot(fonts, handle.index);
+    if (!slot) {
+        slot = TTF_OpenFont(filePath.c_str(), fontSize);
+    }
+    return handle;
 }
 
-TTF_Font* AssetStore::GetFont(const std::string& assetId) {
-    return fonts[assetId];
+TTF_Font* AssetStore::GetFont(FontHandle handle) const {
+    return GetAsset(fonts, handle.index);
 }
 
-void AssetStore::AddAudio(const std::string& assetId, const std::string& filePath) {
-    audios.emplace(assetId, Mix_LoadWAV(filePath.c_str()));
+AudioHandle AssetStore::AddAudio(const std::string& assetId, const std::string& filePath) {
+    AudioHandle handle(assetId);
+    Mix_Chunk*& slot = GetSlot(audios, handle.index);
+    if (!slot) {
+        slot = Mix_LoadWAV(filePath.c_str());
+    }
+    return handle;
 }
 
-Mix_Chunk* AssetStore::GetAudio(const std::string& assetId) {
-    return audios[assetId];
+Mix_Chunk* AssetStore::GetAudio(AudioHandle handle) const {
+    return GetAsset(audios, handle.index);
 }
@@ -1,27 +1,36 @@
 #pragma once
+#include "AssetHandle.h"
 #include <string>
-#include <map>
+#include <vector>
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
 
+////////////////////////////////////////////////////////////////////////////////
+// AssetStore
+////////////////////////////////////////////////////////////////////////////////
+// Assets are stored in arrays indexed by their handle. The string ids are only
+// used when an asset is added or when a handle is created, getting an asset
+// during the game loop is a bounds check and an array access.
+////////////////////////////////////////////////////////////////////////////////
 class AssetStore {
 private:
-	std::map<std::string, SDL_Texture*> textures;
-	std::map<std::string, TTF_Font*> fonts;
-	std::map<std::string, Mix_Chunk*> audios;
+	// [Vector index = asset handle index]
+	std::vector<SDL_Texture*> textures;
+	std::vector<TTF_Font*> fonts;
+	std::vector<Mix_Chunk*> audios;
 
 public:
 	AssetStore();
 	~AssetStore();
 
 	void ClearAssets();
-	void AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath);
-	SDL_Texture* GetTexture(const std::string& assetId);
+	TextureHandle AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath);
+	SDL_Texture* GetTexture(TextureHandle handle) const;
 
-	void AddFont(const std::string& assetId, const std::string& filePath, int fontSize);
-	TTF_Font* GetFont(const std::string& assetId);
+	FontHandle AddFont(const std::string& assetId, const std::string& filePath, int fontSize);
+	TTF_Font* GetFont(FontHandle handle) const;
 
-	void AddAudio(const std::string& assetId, const std::string& filePath);
-	Mix_Chunk* GetAudio(const std::string& assetId);
-};
\ No newline at end of file
+	AudioHandle AddAudio(const std::string& assetId, const std::string& filePath);
+	Mix_Chunk* GetAudio(AudioHandle handle) const;
+};
@@ -1,7 +1,11 @@
 #pragma once
+#include "ComponentIds.h"
+#include "../ECS/Snapshot.h"
 #include <SDL.h>
 
 struct AnimationComponent {
+	static constexpr int COMPONENT_ID = ANIMATION_COMPONENT_ID;
+
 	int numFrames;
 	int currentFrame;
 	int frameSpeedRate;
@@ -16,3 +20,28 @@ struct AnimationComponent {
 		this->startTime = SDL_GetTicks();
 	}
 };
+
+// Animations keep their progress: the startTime is shifted by the ticks elapsed since the snapshot was saved
+template <>
+struct ComponentSerializer<AnimationComponent> {
+	static const bool IS_SERIALIZABLE = true;
+	static const size_t MIN_BYTES = sizeof(AnimationComponent);
+
+	static void Write(SnapshotWriter& writer, const AnimationComponent* animations, int count) {
+		writer.Write(static_cast<int32_t>(SDL_GetTicks()));
+		writer.WriteArray(animations, count);
+	}
+
+	static bool Read(SnapshotReader& reader, AnimationComponent* animations, int count) {
+		int32_t savedTicks;
+		if (!reader.Read(savedTicks) || !reader.ReadArray(animations, count)) {
+			return false;
+		}
+		NormalizeBools(animations, count, &AnimationComponent::isLoop);
+		const int elapsedTicks = static_cast<int>(SDL_GetTicks()) - savedTicks;
+		for (int i = 0; i < count; i++) {
+			animations[i].startTime += elapsedTicks;
+		}
+		return true;
+	}
+};
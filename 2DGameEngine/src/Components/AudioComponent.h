@@ -1,12 +1,40 @@
 #pragma once
-#include <string>
+#include "ComponentIds.h"
+#include "../AssetStore/AssetHandle.h"
+#include "../ECS/Snapshot.h"
 
 struct AudioComponent {
-	std::string assetId;
+	static constexpr int COMPONENT_ID = AUDIO_COMPONENT_ID;
+
+	AudioHandle assetId;
 	int channel;
 
-	AudioComponent(std::string assetId = "", int channel = -1) {
+	// Set to stop the sound, the PlayAudioSystem halts the channel on the main thread
+	bool isHaltRequested;
+
+	AudioComponent(AudioHandle assetId = AudioHandle(), int channel = -1) {
 		this->assetId = assetId;
 		this->channel = channel;
+		this->isHaltRequested = false;
+	}
+};
+
+// Sounds are saved with the names of their audio assets
+template <>
+struct ComponentSerializer<AudioComponent> {
+	static const bool IS_SERIALIZABLE = true;
+	static const size_t MIN_BYTES = sizeof(AudioComponent);
+
+	static void Write(SnapshotWriter& writer, const AudioComponent* sounds, int count) {
+		writer.WriteArray(sounds, count);
+		WriteAssetNames(writer, sounds, count, &AudioComponent::assetId);
+	}
+
+	static bool Read(SnapshotReader& reader, AudioComponent* sounds, int count) {
+		if (!reader.ReadArray(sounds, count)) {
+			return false;
+		}
+		NormalizeBools(sounds, count, &AudioComponent::isHaltRequested);
+		return ReadAssetNames(reader, sounds, count, &AudioComponent::assetId);
 	}
-};
\ No newline at end of file
+};
@@ -1,14 +1,36 @@
 #pragma once
+#include "ComponentIds.h"
 #include <glm/glm.hpp>
+#include <cstdint>
+
+// Collision layers of the game, a collider belongs to one of them and lists the ones it collides with
+enum CollisionLayer : uint32_t {
+	COLLISION_LAYER_NONE = 0,
+	COLLISION_LAYER_DEFAULT = 1 << 0,
+	COLLISION_LAYER_PLAYER = 1 << 1,
+	COLLISION_LAYER_ENEMIES = 1 << 2,
+	COLLISION_LAYER_PROJECTILES = 1 << 3,
+	COLLISION_LAYER_OBSTACLES = 1 << 4,
+	COLLISION_LAYER_ALL = 0xFFFFFFFF
+};
 
 struct BoxColliderComponent {
+	static constexpr int COMPONENT_ID = BOX_COLLIDER_COMPONENT_ID;
+
 	int width;
 	int height;
 	glm::vec2 offset;
 
-	BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0)) {
+	// Two colliders only collide when each one has the layer of the other in its mask, the pairs
+	// that fail are dropped by the broadphase before any overlap test
+	uint32_t layer;
+	uint32_t collidesWith;
+
+	BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0), uint32_t layer = COLLISION_LAYER_DEFAULT, uint32_t collidesWith = COLLISION_LAYER_ALL) {
 		this->width = width;
 		this->height = height;
 		this->offset = offset;
+		this->layer = layer;
+		this->collidesWith = collidesWith;
 	}
-};
\ No newline at end of file
+};
@@ -1,5 +1,8 @@
 #pragma once
+#include "ComponentIds.h"
 
 struct CameraFollowComponent {
+	static constexpr int COMPONENT_ID = CAMERA_FOLLOW_COMPONENT_ID;
+
 	CameraFollowComponent() = default;
 };
\ No newline at end of file
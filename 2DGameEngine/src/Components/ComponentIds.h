@@ -0,0 +1,25 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// ComponentIds
+////////////////////////////////////////////////////////////////////////////////
+// Compile-time id of every component type, used as its bit in the entity
+// signatures. New components get the next id here, and declare it with a
+// static COMPONENT_ID member.
+////////////////////////////////////////////////////////////////////////////////
+enum ComponentIds {
+    TRANSFORM_COMPONENT_ID,
+    RIGID_BODY_COMPONENT_ID,
+    SPRITE_COMPONENT_ID,
+    ANIMATION_COMPONENT_ID,
+    BOX_COLLIDER_COMPONENT_ID,
+    KEYBOARD_CONTROLLED_COMPONENT_ID,
+    CAMERA_FOLLOW_COMPONENT_ID,
+    PROJECTILE_EMITTER_COMPONENT_ID,
+    PROJECTILE_COMPONENT_ID,
+    HEALTH_COMPONENT_ID,
+    TEXT_LABEL_COMPONENT_ID,
+    SCRIPT_COMPONENT_ID,
+    AUDIO_COMPONENT_ID,
+    NUM_COMPONENT_IDS
+};
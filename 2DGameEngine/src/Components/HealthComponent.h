@@ -1,6 +1,9 @@
 #pragma once
+#include "ComponentIds.h"
 
 struct HealthComponent {
+    static constexpr int COMPONENT_ID = HEALTH_COMPONENT_ID;
+
     int healthPercentage;
 
     HealthComponent(int healthPercentage = 0) {
@@ -1,7 +1,10 @@
 #pragma once
+#include "ComponentIds.h"
 #include <glm/glm.hpp>
 
 struct KeyboardControlledComponent {
+	static constexpr int COMPONENT_ID = KEYBOARD_CONTROLLED_COMPONENT_ID;
+
 	glm::vec2 upVelocity;
 	glm::vec2 rightVelocity;
 	glm::vec2 downVelocity;
@@ -1,7 +1,11 @@
 #pragma once
+#include "ComponentIds.h"
+#include "../ECS/Snapshot.h"
 #include <SDL.h>
 
 struct ProjectileComponent {
+	static constexpr int COMPONENT_ID = PROJECTILE_COMPONENT_ID;
+
 	bool isFriendly;
 	int hitPercentDamage;
 	int duration;
@@ -13,4 +17,29 @@ struct ProjectileComponent {
 		this->duration = duration;
 		this->startTime = SDL_GetTicks();
 	}
-};
\ No newline at end of file
+};
+
+// Projectiles keep their age across sessions, so they expire as if the game had not been interrupted
+template <>
+struct ComponentSerializer<ProjectileComponent> {
+	static const bool IS_SERIALIZABLE = true;
+	static const size_t MIN_BYTES = sizeof(ProjectileComponent);
+
+	static void Write(SnapshotWriter& writer, const ProjectileComponent* projectiles, int count) {
+		writer.Write(static_cast<int32_t>(SDL_GetTicks()));
+		writer.WriteArray(projectiles, count);
+	}
+
+	static bool Read(SnapshotReader& reader, ProjectileComponent* projectiles, int count) {
+		int32_t savedTicks;
+		if (!reader.Read(savedTicks) || !reader.ReadArray(projectiles, count)) {
+			return false;
+		}
+		NormalizeBools(projectiles, count, &ProjectileComponent::isFriendly);
+		const int elapsedTicks = static_cast<int>(SDL_GetTicks()) - savedTicks;
+		for (int i = 0; i < count; i++) {
+			projectiles[i].startTime += elapsedTicks;
+		}
+		return true;
+	}
+};
@@ -1,8 +1,12 @@
 #pragma once
+#include "ComponentIds.h"
+#include "../ECS/Snapshot.h"
 #include <glm/glm.hpp>
 #include <SDL.h>
 
 struct ProjectileEmitterComponent {
+	static constexpr int COMPONENT_ID = PROJECTILE_EMITTER_COMPONENT_ID;
+
 	glm::vec2 projectileVelocity;
 	int repeatFrequency;
 	int projectileDuration;
@@ -18,4 +22,29 @@ struct ProjectileEmitterComponent {
 		this->isFriendly = isFriendly;
 		this->lastEmissionTime = SDL_GetTicks();
 	}
-};
\ No newline at end of file
+};
+
+// Emitters keep the time since their last emission, so a loaded snapshot does not make them all fire at once
+template <>
+struct ComponentSerializer<ProjectileEmitterComponent> {
+	static const bool IS_SERIALIZABLE = true;
+	static const size_t MIN_BYTES = sizeof(ProjectileEmitterComponent);
+
+	static void Write(SnapshotWriter& writer, const ProjectileEmitterComponent* emitters, int count) {
+		writer.Write(static_cast<int32_t>(SDL_GetTicks()));
+		writer.WriteArray(emitters, count);
+	}
+
+	static bool Read(SnapshotReader& reader, ProjectileEmitterComponent* emitters, int count) {
+		int32_t savedTicks;
+		if (!reader.Read(savedTicks) || !reader.ReadArray(emitters, count)) {
+			return false;
+		}
+		NormalizeBools(emitters, count, &ProjectileEmitterComponent::isFriendly);
+		const int elapsedTicks = static_cast<int>(SDL_GetTicks()) - savedTicks;
+		for (int i = 0; i < count; i++) {
+			emitters[i].lastEmissionTime += elapsedTicks;
+		}
+		return true;
+	}
+};
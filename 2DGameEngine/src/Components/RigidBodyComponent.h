@@ -1,7 +1,10 @@
 #pragma once
+#include "ComponentIds.h"
 #include <glm/glm.hpp>
 
 struct RigidBodyComponent {
+	static constexpr int COMPONENT_ID = RIGID_BODY_COMPONENT_ID;
+
 	glm::vec2 velocity;
 
 	RigidBodyComponent(glm::vec2 velocity = glm::vec2(0.0, 0.0)) {
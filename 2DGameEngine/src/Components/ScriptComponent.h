@@ -1,7 +1,10 @@
 #pragma once
+#include "ComponentIds.h"
 #include <sol/sol.hpp>
 
 struct ScriptComponent {
+	static constexpr int COMPONENT_ID = SCRIPT_COMPONENT_ID;
+
 	sol::function func;
 
 	ScriptComponent(sol::function func = sol::lua_nil) {
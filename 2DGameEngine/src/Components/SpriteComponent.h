@@ -1,9 +1,13 @@
 #pragma once
-#include <string>
+#include "ComponentIds.h"
+#include "../AssetStore/AssetHandle.h"
+#include "../ECS/Snapshot.h"
 #include <SDL.h>
 
 struct SpriteComponent {
-	std::string assetId;
+	static constexpr int COMPONENT_ID = SPRITE_COMPONENT_ID;
+
+	TextureHandle assetId;
 	int width;
 	int height;
 	int zIndex;
@@ -11,7 +15,7 @@ struct SpriteComponent {
 	bool isFixed;
 	SDL_Rect srcRect;
 
-	SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int zIndex = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0) {
+	SpriteComponent(TextureHandle assetId = TextureHandle(), int width = 0, int height = 0, int zIndex = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0) {
 		this->assetId = assetId;
 		this->width = width;
 		this->height = height;
@@ -20,4 +24,24 @@ struct SpriteComponent {
 		this->isFixed = isFixed;
 		this->srcRect = { srcRectX, srcRectY, width, height };
 	}
-};
\ No newline at end of file
+};
+
+// The texture handles are saved by name, and the flip and isFixed fields are checked on load
+template <>
+struct ComponentSerializer<SpriteComponent> {
+	static const bool IS_SERIALIZABLE = true;
+	static const size_t MIN_BYTES = sizeof(SpriteComponent);
+
+	static void Write(SnapshotWriter& writer, const SpriteComponent* sprites, int count) {
+		writer.WriteArray(sprites, count);
+		WriteAssetNames(writer, sprites, count, &SpriteComponent::assetId);
+	}
+
+	static bool Read(SnapshotReader& reader, SpriteComponent* sprites, int count) {
+		if (!reader.ReadArray(sprites, count) || !AreEnumsInRange(sprites, count, &SpriteComponent::flip, SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL)) {
+			return false;
+		}
+		NormalizeBools(sprites, count, &SpriteComponent::isFixed);
+		return ReadAssetNames(reader, sprites, count, &SpriteComponent::assetId);
+	}
+};
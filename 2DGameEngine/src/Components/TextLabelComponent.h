@@ -1,16 +1,21 @@
 #pragma once
+#include "ComponentIds.h"
+#include "../AssetStore/AssetHandle.h"
+#include "../ECS/Snapshot.h"
 #include <string>
 #include <glm/glm.hpp>
 #include <SDL.h>
 
 struct TextLabelComponent {
+    static constexpr int COMPONENT_ID = TEXT_LABEL_COMPONENT_ID;
+
     glm::vec2 position;
     std::string text;
-    std::string assetId;
+    FontHandle assetId;
     SDL_Color color;
     bool isFixed;
 
-    TextLabelComponent(glm::vec2 position = glm::vec2(0), const std::string& text = "", const std::string& assetId = "", const SDL_Color& color = { 0, 0, 0 }, bool isFixed = true) {
+    TextLabelComponent(glm::vec2 position = glm::vec2(0), const std::string& text = "", FontHandle assetId = FontHandle(), const SDL_Color& color = { 0, 0, 0 }, bool isFixed = true) {
         this->position = position;
         this->text = text;
         this->assetId = assetId;
@@ -18,3 +23,33 @@ struct TextLabelComponent {
         this->isFixed = isFixed;
     }
 };
+
+// Labels hold a string, so they are written one by one, with the font handles saved by name
+template <>
+struct ComponentSerializer<TextLabelComponent> {
+    static const bool IS_SERIALIZABLE = true;
+    static const size_t MIN_BYTES = sizeof(glm::vec2) + sizeof(uint32_t) + sizeof(FontHandle) + sizeof(SDL_Color) + sizeof(uint8_t);
+
+    static void Write(SnapshotWriter& writer, const TextLabelComponent* labels, int count) {
+        for (int i = 0; i < count; i++) {
+            writer.Write(labels[i].position);
+            writer.WriteString(labels[i].text);
+            writer.Write(labels[i].assetId);
+            writer.Write(labels[i].color);
+            writer.Write(static_cast<uint8_t>(labels[i].isFixed));
+        }
+        WriteAssetNames(writer, labels, count, &TextLabelComponent::assetId);
+    }
+
+    static bool Read(SnapshotReader& reader, TextLabelComponent* labels, int count) {
+        for (int i = 0; i < count; i++) {
+            uint8_t isFixed;
+            if (!reader.Read(labels[i].position) || !reader.ReadString(labels[i].text) || !reader.Read(labels[i].assetId) ||
+                !reader.Read(labels[i].color) || !reader.Read(isFixed)) {
+                return false;
+            }
+            labels[i].isFixed = isFixed != 0;
+        }
+        return ReadAssetNames(reader, labels, count, &TextLabelComponent::assetId);
+    }
+};
@@ -1,7 +1,10 @@
 #pragma once
+#include "ComponentIds.h"
 #include <glm/glm.hpp>
 
 struct TransformComponent {
+	static constexpr int COMPONENT_ID = TRANSFORM_COMPONENT_ID;
+
 	glm::vec2 position;
 	glm::vec2 scale;
 	double rotation;
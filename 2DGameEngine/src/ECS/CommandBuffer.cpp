@@ -0,0 +1,120 @@
+#include "CommandBuffer.h"
+
+Entity CommandBuffer::Resolve(const CommandTarget& target) const {
+    return target.pendingIndex == -1 ? target.entity : createdEntities[target.pendingIndex];
+}
+
+PendingEntity CommandBuffer::CreateEntity() {
+    entitiesToCreate.push_back(nullptr);
+    return PendingEntity{ static_cast<int>(entitiesToCreate.size()) - 1 };
+}
+
+PendingEntity CommandBuffer::Instantiate(const Prefab& prefab) {
+    entitiesToCreate.push_back(&prefab);
+    return PendingEntity{ static_cast<int>(entitiesToCreate.size()) - 1 };
+}
+
+void CommandBuffer::KillEntity(CommandTarget target) {
+    entitiesToBeKilled.push_back(target);
+}
+
+void CommandBuffer::TagEntity(CommandTarget target, const std::string& tag) {
+    tagsToBeAdded.push_back({ target, tag });
+}
+
+void CommandBuffer::GroupEntity(CommandTarget target, const std::string& group) {
+    groupsToBeAdded.push_back({ target, group });
+}
+
+bool CommandBuffer::IsEmpty() const {
+    if (!entitiesToCreate.empty() || !tagsToBeAdded.empty() || !groupsToBeAdded.empty() || !componentsToBeRemoved.empty() || !entitiesToBeKilled.empty()) {
+        return false;
+    }
+    for (auto& column : componentColumns) {
+        if (column && !column->IsEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CommandBuffer::Clear() {
+    entitiesToCreate.clear();
+    createdEntities.clear();
+    for (auto& column : componentColumns) {
+        if (column) {
+            column->Clear();
+        }
+    }
+    tagsToBeAdded.clear();
+    groupsToBeAdded.clear();
+    componentsToBeRemoved.clear();
+    entitiesToBeKilled.clear();
+}
+
+void CommandBuffer::Flush(Registry& registry) {
+    if (IsEmpty()) {
+        return;
+    }
+
+    // Entities that cannot be created (the registry ran out of entity ids) resolve to an invalid
+    // entity, which is never alive, so the commands aimed at them are dropped below
+    createdEntities.clear();
+    size_t i = 0;
+    while (i < entitiesToCreate.size()) {
+        // Consecutive instances of the same prefab are instantiated together
+        const Prefab* prefab = entitiesToCreate[i];
+        size_t count = 1;
+        while (i + count < entitiesToCreate.size() && entitiesToCreate[i + count] == prefab) {
+            count++;
+        }
+
+        if (prefab) {
+            registry.InstantiateEntities(*prefab, static_cast<int>(count), createdEntities);
+        }
+        else {
+            for (size_t j = 0; j < count; j++) {
+                createdEntities.push_back(registry.CreateEntity());
+            }
+        }
+        i += count;
+    }
+    entitiesToCreate.clear();
+
+    // Columns are replayed by component type id and keep their storage for the next frame
+    for (auto& column : componentColumns) {
+        if (column && !column->IsEmpty()) {
+            column->Flush(registry, *this);
+        }
+    }
+
+    // Commands aimed at entities that were killed in the meantime are dropped
+    for (auto& command : tagsToBeAdded) {
+        Entity entity = Resolve(command.target);
+        if (registry.IsEntityAlive(entity)) {
+            registry.TagEntity(entity, command.name);
+        }
+    }
+    tagsToBeAdded.clear();
+
+    for (auto& command : groupsToBeAdded) {
+        Entity entity = Resolve(command.target);
+        if (registry.IsEntityAlive(entity)) {
+            registry.GroupEntity(entity, command.name);
+        }
+    }
+    groupsToBeAdded.clear();
+
+    for (auto& command : componentsToBeRemoved) {
+        Entity entity = Resolve(command.target);
+        if (registry.IsEntityAlive(entity)) {
+            registry.RemoveComponent(entity, command.componentId);
+        }
+    }
+    componentsToBeRemoved.clear();
+
+    for (auto& target : entitiesToBeKilled) {
+        registry.KillEntity(Resolve(target));
+    }
+    entitiesToBeKilled.clear();
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "ECS.h"
+#include "Prefab.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+// PendingEntity
+////////////////////////////////////////////////////////////////////////////////
+// Placeholder for an entity created through a command buffer, which only gets
+// a real entity id when the buffer is flushed.
+////////////////////////////////////////////////////////////////////////////////
+struct PendingEntity {
+    int index;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// CommandBuffer
+////////////////////////////////////////////////////////////////////////////////
+// Records entity creation, component additions/removals, tags, groups and
+// kills without touching the registry, so systems running on worker threads
+// can spawn and mutate entities. The registry replays every buffer in the
+// order the buffers were created, at the start of its next Update().
+// Within a buffer, creations (and prefab instantiations) are applied first,
+// then component additions
+// (grouped per component type, in recording order), tags and groups,
+// component removals and finally kills.
+////////////////////////////////////////////////////////////////////////////////
+class CommandBuffer {
+private:
+    // Either an existing entity or an entity created by this buffer
+    struct CommandTarget {
+        Entity entity;
+        int pendingIndex;
+
+        CommandTarget(Entity entity) : entity(entity), pendingIndex(-1) {}
+        CommandTarget(PendingEntity pendingEntity) : entity(0), pendingIndex(pendingEntity.index) {}
+    };
+
+    class IComponentColumn {
+    public:
+        virtual ~IComponentColumn() = default;
+        virtual bool IsEmpty() const = 0;
+        virtual void Flush(Registry& registry, const CommandBuffer& commandBuffer) = 0;
+        virtual void Clear() = 0;
+    };
+
+    // The components of a single type added through this buffer, stored contiguously
+    template <typename TComponent>
+    class ComponentColumn : public IComponentColumn {
+    public:
+        std::vector<CommandTarget> targets;
+        std::vector<TComponent> components;
+
+        bool IsEmpty() const override {
+            return components.empty();
+        }
+
+        void Flush(Registry& registry, const CommandBuffer& commandBuffer) override {
+            // Grow the pool once for the whole column
+            registry.ReserveComponents<TComponent>(static_cast<int>(components.size()));
+            for (size_t i = 0; i < components.size(); i++) {
+                Entity entity = commandBuffer.Resolve(targets[i]);
+                if (registry.IsEntityAlive(entity)) {
+                    registry.AddComponent<TComponent>(entity, std::move(components[i]));
+                }
+            }
+            Clear();
+        }
+
+        void Clear() override {
+            targets.clear();
+            components.clear();
+        }
+    };
+
+    struct NameCommand {
+        CommandTarget target;
+        std::string name;
+    };
+
+    struct RemoveCommand {
+        CommandTarget target;
+        int componentId;
+    };
+
+    // Prefab of each entity to create [nullptr = entity without components]
+    std::vector<const Prefab*> entitiesToCreate;
+    std::vector<Entity> createdEntities;
+
+    // [Vector index = component type id]
+    std::vector<std::unique_ptr<IComponentColumn>> componentColumns;
+
+    std::vector<NameCommand> tagsToBeAdded;
+    std::vector<NameCommand> groupsToBeAdded;
+    std::vector<RemoveCommand> componentsToBeRemoved;
+    std::vector<CommandTarget> entitiesToBeKilled;
+
+    Entity Resolve(const CommandTarget& target) const;
+
+    template <typename TComponent> ComponentColumn<TComponent>& GetOrCreateColumn();
+
+public:
+    CommandBuffer() = default;
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator =(const CommandBuffer&) = delete;
+
+    PendingEntity CreateEntity();
+
+    // The prefab must outlive the next flush. Components added to the pending entity afterwards
+    // replace the prefab values.
+    PendingEntity Instantiate(const Prefab& prefab);
+    void KillEntity(CommandTarget target);
+    void TagEntity(CommandTarget target, const std::string& tag);
+    void GroupEntity(CommandTarget target, const std::string& group);
+
+    template <typename TComponent, typename ...TArgs> void AddComponent(CommandTarget target, TArgs&& ...args);
+    template <typename TComponent> void RemoveComponent(CommandTarget target);
+
+    bool IsEmpty() const;
+
+    // Drops every recorded command without applying it
+    void Clear();
+
+    // Applies every recorded command to the registry and clears the buffer
+    void Flush(Registry& registry);
+};
+
+template <typename TComponent>
+CommandBuffer::ComponentColumn<TComponent>& CommandBuffer::GetOrCreateColumn() {
+    const auto componentId = Component<TComponent>::GetId();
+    if (componentId >= static_cast<int>(componentColumns.size())) {
+        componentColumns.resize(componentId + 1);
+    }
+    if (!componentColumns[componentId]) {
+        componentColumns[componentId] = std::make_unique<ComponentColumn<TComponent>>();
+    }
+    return *static_cast<ComponentColumn<TComponent>*>(componentColumns[componentId].get());
+}
+
+template <typename TComponent, typename ...TArgs>
+void CommandBuffer::AddComponent(CommandTarget target, TArgs&& ...args) {
+    auto& column = GetOrCreateColumn<TComponent>();
+    column.targets.push_back(target);
+    column.components.emplace_back(std::forward<TArgs>(args)...);
+}
+
+template <typename TComponent>
+void CommandBuffer::RemoveComponent(CommandTarget target) {
+    componentsToBeRemoved.push_back({ target, Component<TComponent>::GetId() });
+}
@@ -1,10 +1,35 @@
 #include "ECS.h"
+#include "CommandBuffer.h"
+#include "Prefab.h"
 #include "../Logger/Logger.h"
 
-int IComponent::nextId = 0;
+Registry* Entity::registry = nullptr;
+
+std::unordered_map<std::string, int> Registry::tagIds;
+std::unordered_map<std::string, int> Registry::groupIds;
 
 int Entity::GetId() const {
-    return id;
+    return static_cast<int>(handle & ENTITY_INDEX_MASK);
+}
+
+int Entity::GetGeneration() const {
+    return static_cast<int>(handle >> ENTITY_INDEX_BITS);
+}
+
+uint32_t Entity::GetHandle() const {
+    return handle;
+}
+
+bool Entity::IsValid() const {
+    return GetId() != static_cast<int>(INVALID_ENTITY_ID);
+}
+
+Entity Entity::Invalid() {
+    return Entity(INVALID_ENTITY_ID);
+}
+
+bool Entity::IsAlive() const {
+    return registry->IsEntityAlive(*this);
 }
 
 void Entity::Kill() {
@@ -19,6 +44,10 @@ bool Entity::HasTag(const std::string& tag) const {
     return registry->EntityHasTag(*this, tag);
 }
 
+bool Entity::HasTag(int tagId) const {
+    return registry->EntityHasTag(*this, tagId);
+}
+
 void Entity::Group(const std::string& group) {
     registry->GroupEntity(*this, group);
 }
@@ -27,17 +56,44 @@ bool Entity::BelongsToGroup(const std::string& group) const {
     return registry->EntityBelongsToGroup(*this, group);
 }
 
+bool Entity::BelongsToGroup(int groupId) const {
+    return registry->EntityBelongsToGroup(*this, groupId);
+}
+
 void System::AddEntityToSystem(Entity entity) {
+    const auto entityId = entity.GetId();
+    if (entityId >= static_cast<int>(entityIndices.size())) {
+        entityIndices.resize(entityId + 1, -1);
+    }
+    if (entityIndices[entityId] != -1) {
+        return;
+    }
+    entityIndices[entityId] = static_cast<int>(entities.size());
     entities.push_back(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity) {
-    entities.erase(std::remove_if(entities.begin(), entities.end(), [&entity](Entity other) {
-        return entity == other;
-    }), entities.end());
+    const auto entityId = entity.GetId();
+    if (entityId >= static_cast<int>(entityIndices.size()) || entityIndices[entityId] == -1) {
+        return;
+    }
+
+    // Move the last entity to the removed position to keep the vector packed
+    const int indexOfRemoved = entityIndices[entityId];
+    const Entity lastEntity = entities.back();
+    entities[indexOfRemoved] = lastEntity;
+    entityIndices[lastEntity.GetId()] = indexOfRemoved;
+
+    entities.pop_back();
+    entityIndices[entityId] = -1;
+}
+
+void System::RemoveAllEntities() {
+    entities.clear();
+    entityIndices.clear();
 }
 
-std::vector<Entity> System::GetSystemEntities() const {
+const std::vector<Entity>& System::GetSystemEntities() const {
     return entities;
 }
 
@@ -45,32 +101,322 @@ const Signature& System::GetComponentSignature() const {
     return componentSignature;
 }
 
-Entity Registry::CreateEntity() {
+const Signature& System::GetReadSignature() const {
+    return readSignature;
+}
+
+const Signature& System::GetWriteSignature() const {
+    return writeSignature;
+}
+
+bool System::IsExclusive() const {
+    return isExclusive;
+}
+
+void System::SetExclusive(bool isExclusive) {
+    this->isExclusive = isExclusive;
+}
+
+Registry::Registry(MemoryArena& memoryArena) : memoryArena(memoryArena) {
+    // A second registry would take over every live entity handle
+    assert(!Entity::registry && "Only one Registry can exist at a time");
+    Entity::registry = this;
+    Logger::Log("Registry constructor called");
+}
+
+Registry::~Registry() {
+    if (Entity::registry == this) {
+        Entity::registry = nullptr;
+    }
+    Logger::Log("Registry destructor called");
+}
+
+void Registry::TrimPools() {
+    ReleaseRecycledEntities();
+    for (auto& pool : componentPools) {
+        if (pool) {
+            pool->Trim();
+        }
+    }
+    memoryArena.Trim();
+}
+
+std::vector<PoolStats> Registry::GetPoolStats() const {
+    std::vector<PoolStats> poolStats;
+    for (auto& pool : componentPools) {
+        if (pool) {
+            poolStats.push_back(pool->GetStats());
+        }
+    }
+    return poolStats;
+}
+
+void Registry::LogPoolStats() const {
+    size_t usedBytes = 0;
+    size_t reservedBytes = 0;
+    for (auto& stats : GetPoolStats()) {
+        Logger::Log("Pool ", stats.componentName, ": ", stats.size, "/", stats.capacity, " objects, ", stats.usedBytes, "/", stats.reservedBytes, " bytes");
+        usedBytes += stats.usedBytes;
+        reservedBytes += stats.reservedBytes;
+    }
+    Logger::Log("Component pools: ", usedBytes, "/", reservedBytes, " bytes used, ", memoryArena.GetReservedBytes(), " bytes held by the memory arena");
+}
+
+MemoryArena& Registry::GetMemoryArena() const {
+    return memoryArena;
+}
+
+CommandBuffer& Registry::CreateCommandBuffer() {
+    commandBuffers.push_back(std::make_unique<CommandBuffer>());
+    return *commandBuffers.back();
+}
+
+Entity Registry::AllocateEntity() {
     int entityId;
 
     // If there are no free ids, add new id and resize
     if (freeIds.empty()) {
+        if (numEntities >= static_cast<int>(MAX_ENTITIES)) {
+            Logger::Err("Maximum number of entities reached (", MAX_ENTITIES, ")");
+            return Entity::Invalid();
+        }
         entityId = numEntities++;
-        if (entityId >= entityComponentSignatures.size()) {
-            entityComponentSignatures.resize(entityId + 1);
+        if (entityId >= static_cast<int>(entityComponentSignatures.size())) {
+            ResizeEntities(entityId + 1);
         }
     }
     else {
         entityId = freeIds.front();
         freeIds.pop_front();
+        isEntityFree[entityId] = false;
     }
     
-    Entity entity(entityId);
-    entity.registry = this;
-    entitiesToBeAdded.insert(entity);
+    Entity entity(entityId, entityGenerations[entityId]);
+    entitiesToBeAdded.push_back(entity);
+    isEntityToBeAdded[entityId] = true;
 
-    Logger::Log("Entity created with id = " + std::to_string(entityId));
+    return entity;
+}
 
+Entity Registry::CreateEntity() {
+    Entity entity = AllocateEntity();
+    if (entity.IsValid()) {
+        Logger::Debug("Entity created with id = ", entity.GetId());
+    }
     return entity;
 }
 
+Prefab& Registry::CreatePrefab(const std::string& name) {
+    auto& prefab = prefabs[name];
+    if (prefab) {
+        ReleaseRecycledEntities(*prefab);
+        prefab->Clear();
+    }
+    else {
+        prefab = std::make_unique<Prefab>(name);
+    }
+    return *prefab;
+}
+
+Prefab* Registry::GetPrefab(const std::string& name) const {
+    auto prefab = prefabs.find(name);
+    return prefab != prefabs.end() ? prefab->second.get() : nullptr;
+}
+
+Entity Registry::Instantiate(const Prefab& prefab) {
+    std::vector<Entity> entities;
+    InstantiateEntities(prefab, 1, entities);
+    if (entities[0].IsValid()) {
+        Logger::Debug("Entity created with id = ", entities[0].GetId(), " from prefab ", prefab.GetName());
+    }
+    return entities[0];
+}
+
+std::vector<Entity> Registry::Instantiate(const Prefab& prefab, int count) {
+    std::vector<Entity> entities;
+    if (count > 0) {
+        entities.reserve(count);
+        InstantiateEntities(prefab, count, entities);
+
+        // The instances that could not be created are at the end
+        while (!entities.empty() && !entities.back().IsValid()) {
+            entities.pop_back();
+        }
+        Logger::Log(entities.size(), " entities created from prefab ", prefab.GetName());
+    }
+    return entities;
+}
+
+void Registry::InstantiateEntities(const Prefab& prefab, int count, std::vector<Entity>& entities) {
+    const size_t firstEntity = entities.size();
+
+    // Recycled instances already have the prefab components in the pools, they only need to be queued again
+    int numRecycled = 0;
+    auto recycledEntities = recycledEntitiesPerPrefab.find(&prefab);
+    if (recycledEntities != recycledEntitiesPerPrefab.end()) {
+        auto& entityIds = recycledEntities->second;
+        while (numRecycled < count && !entityIds.empty()) {
+            const int entityId = entityIds.back();
+            entityIds.pop_back();
+            isEntityFree[entityId] = false;
+
+            Entity entity(entityId, entityGenerations[entityId]);
+            entitiesToBeAdded.push_back(entity);
+            isEntityToBeAdded[entityId] = true;
+            entities.push_back(entity);
+            numRecycled++;
+        }
+    }
+
+    // One copy per component type for the new entities, each pool is grown once for all of them.
+    // Once the entity ids run out every following allocation fails, so the new entities stay contiguous.
+    int numNewEntities = 0;
+    if (count > numRecycled) {
+        ReserveEntities(count - numRecycled);
+        for (int i = numRecycled; i < count; i++) {
+            const Entity entity = AllocateEntity();
+            if (!entity.IsValid()) {
+                entities.resize(firstEntity + count, Entity::Invalid());
+                break;
+            }
+            entities.push_back(entity);
+            numNewEntities++;
+        }
+    }
+    if (numNewEntities > 0) {
+        for (auto& component : prefab.components) {
+            if (component) {
+                component->CopyTo(*this, &entities[firstEntity + numRecycled], numNewEntities);
+            }
+        }
+    }
+
+    const size_t lastEntity = firstEntity + numRecycled + numNewEntities;
+    for (size_t i = firstEntity; i < lastEntity; i++) {
+        const auto entityId = entities[i].GetId();
+
+        // The entities are still waiting to be added to the systems, which match them with this signature
+        entityComponentSignatures[entityId] = prefab.signature;
+        for (auto& pack : componentPacks) {
+            PackEntity(entityId, pack.componentIds[0]);
+        }
+
+        if (prefab.tagId != -1) {
+            TagEntity(entities[i], prefab.tagId);
+        }
+        if (prefab.groupId != -1) {
+            GroupEntity(entities[i], prefab.groupId);
+        }
+        recyclingPrefabPerEntity[entityId] = prefab.IsRecycling() ? &prefab : nullptr;
+    }
+}
+
+void Registry::ReleaseRecycledEntities(const Prefab& prefab) {
+    auto recycledEntities = recycledEntitiesPerPrefab.find(&prefab);
+    if (recycledEntities == recycledEntitiesPerPrefab.end()) {
+        return;
+    }
+    for (int entityId : recycledEntities->second) {
+        for (auto& pool : componentPools) {
+            if (pool) {
+                pool->RemoveEntityFromPool(entityId);
+            }
+        }
+        recyclingPrefabPerEntity[entityId] = nullptr;
+        freeIds.push_back(entityId);
+    }
+    recycledEntitiesPerPrefab.erase(recycledEntities);
+}
+
+void Registry::ReleaseRecycledEntities() {
+    while (!recycledEntitiesPerPrefab.empty()) {
+        ReleaseRecycledEntities(*recycledEntitiesPerPrefab.begin()->first);
+    }
+}
+
+// Reserves at least the requested capacity, at least doubling it so small repeated reserves do not reallocate every time
+template <typename TVector>
+static void ReserveAtLeast(TVector& vector, size_t capacity) {
+    if (capacity > vector.capacity()) {
+        vector.reserve(std::max(capacity, vector.capacity() * 2));
+    }
+}
+
+void Registry::ReserveEntities(int count) {
+    // Grow the per-entity arrays once for the ids that cannot be recycled
+    const int numNewIds = std::max(count - static_cast<int>(freeIds.size()), 0);
+    const size_t capacity = static_cast<size_t>(numEntities) + numNewIds;
+    ReserveAtLeast(entityComponentSignatures, capacity);
+    ReserveAtLeast(entityGenerations, capacity);
+    ReserveAtLeast(isEntityToBeAdded, capacity);
+    ReserveAtLeast(isEntityToBeKilled, capacity);
+    ReserveAtLeast(isEntitySignatureChanged, capacity);
+    ReserveAtLeast(previousComponentSignatures, capacity);
+    ReserveAtLeast(componentsToBeRemoved, capacity);
+    ReserveAtLeast(tagPerEntity, capacity);
+    ReserveAtLeast(groupPerEntity, capacity);
+    ReserveAtLeast(groupIndexPerEntity, capacity);
+    ReserveAtLeast(recyclingPrefabPerEntity, capacity);
+    ReserveAtLeast(isEntityFree, capacity);
+    ReserveAtLeast(entitiesToBeAdded, entitiesToBeAdded.size() + count);
+}
+
+void Registry::ResizeEntities(int count) {
+    entityComponentSignatures.resize(count);
+    entityGenerations.resize(count, 0);
+    isEntityToBeAdded.resize(count, false);
+    isEntityToBeKilled.resize(count, false);
+    isEntitySignatureChanged.resize(count, false);
+    previousComponentSignatures.resize(count);
+    componentsToBeRemoved.resize(count);
+    tagPerEntity.resize(count, -1);
+    groupPerEntity.resize(count, -1);
+    groupIndexPerEntity.resize(count, -1);
+    recyclingPrefabPerEntity.resize(count, nullptr);
+    isEntityFree.resize(count, false);
+}
+
+std::vector<Entity> Registry::CreateEntities(int count) {
+    std::vector<Entity> entities;
+    if (count <= 0) {
+        return entities;
+    }
+    entities.reserve(count);
+    ReserveEntities(count);
+
+    for (int i = 0; i < count; i++) {
+        const Entity entity = AllocateEntity();
+        if (!entity.IsValid()) {
+            break;
+        }
+        entities.push_back(entity);
+    }
+
+    if (!entities.empty()) {
+        Logger::Log(entities.size(), " entities created, from id = ", entities.front().GetId());
+    }
+
+    return entities;
+}
+
 void Registry::KillEntity(Entity entity) {
-    entitiesToBeKilled.insert(entity);
+    std::lock_guard<std::mutex> lock(killMutex);
+
+    // Stale handles must not kill the entity that now occupies the slot
+    if (!IsEntityAlive(entity) || isEntityToBeKilled[entity.GetId()]) {
+        return;
+    }
+    isEntityToBeKilled[entity.GetId()] = true;
+    entitiesToBeKilled.push_back(entity);
+}
+
+bool Registry::IsEntityAlive(Entity entity) const {
+    const auto entityId = entity.GetId();
+    return entity.IsValid() && entityId < numEntities && !isEntityFree[entityId] && entityGenerations[entityId] == entity.GetGeneration();
+}
+
+Entity Registry::GetEntity(int entityId) const {
+    return Entity(entityId, entityGenerations[entityId]);
 }
 
 void Registry::AddEntityToSystems(Entity entity) {
@@ -81,7 +427,7 @@ void Registry::AddEntityToSystems(Entity entity) {
     for (auto& system : systems) {
         const auto& systemComponentSignature = system.second->GetComponentSignature();
 
-        bool isInterested = (entityComponentSignature & systemComponentSignature) == systemComponentSignature;
+        bool isInterested = entityComponentSignature.Contains(systemComponentSignature);
 
         if (isInterested) {
             system.second->AddEntityToSystem(entity);
@@ -89,93 +435,304 @@ void Registry::AddEntityToSystems(Entity entity) {
     }
 }
 
+void Registry::UpdateEntitySystems(Entity entity, const Signature& oldSignature, const Signature& newSignature) {
+    const Signature changedComponents = oldSignature ^ newSignature;
+    if (changedComponents.none()) {
+        return;
+    }
+
+    for (auto& system : systems) {
+        const auto& systemComponentSignature = system.second->GetComponentSignature();
+        if (!systemComponentSignature.Intersects(changedComponents)) {
+            continue;
+        }
+
+        bool wasInterested = oldSignature.Contains(systemComponentSignature);
+        bool isInterested = newSignature.Contains(systemComponentSignature);
+
+        if (isInterested && !wasInterested) {
+            system.second->AddEntityToSystem(entity);
+        }
+        if (wasInterested && !isInterested) {
+            system.second->RemoveEntityFromSystem(entity);
+        }
+    }
+}
+
+void Registry::OnSignatureChanged(Entity entity, const Signature& oldSignature) {
+    const auto entityId = entity.GetId();
+    if (isEntitySignatureChanged[entityId]) {
+        return;
+    }
+
+    // New entities are matched when they are added, unless a pool entry has to be released
+    if (isEntityToBeAdded[entityId] && componentsToBeRemoved[entityId].none()) {
+        return;
+    }
+    isEntitySignatureChanged[entityId] = true;
+    previousComponentSignatures[entityId] = oldSignature;
+    entitiesWithChangedSignature.push_back(entity);
+}
+
+void Registry::RemoveComponent(Entity entity, int componentId) {
+
+    const auto entityId = entity.GetId();
+
+    if (!entityComponentSignatures[entityId].test(componentId)) {
+        return;
+    }
+
+    // Turn off the component signature -> The entity no longer has this component
+    const Signature oldSignature = entityComponentSignatures[entityId];
+    UnpackEntity(entityId, componentId);
+    entityComponentSignatures[entityId].set(componentId, false);
+
+    // The component object stays in its pool until the next Update(), so the systems that
+    // still iterate the entity in this frame can safely access it
+    componentsToBeRemoved[entityId].set(componentId);
+    OnSignatureChanged(entity, oldSignature);
+
+    Logger::Debug("Component id = ", componentId, " was removed from entity id ", entityId);
+}
+
 void Registry::RemoveEntityFromSystems(Entity entity) {
-    for (auto system : systems) {
+    for (auto& system : systems) {
         system.second->RemoveEntityFromSystem(entity);
     }
 }
 
+void Registry::PackEntity(int entityId, int componentId) {
+    if (componentId >= static_cast<int>(packPerComponent.size()) || packPerComponent[componentId] == -1) {
+        return;
+    }
+    auto& pack = componentPacks[packPerComponent[componentId]];
+
+    // Only pack entities that have all the pack components and are not packed yet
+    if (!entityComponentSignatures[entityId].Contains(pack.signature)) {
+        return;
+    }
+    if (componentPools[componentId]->GetIndex(entityId) < pack.size) {
+        return;
+    }
+
+    for (auto packComponentId : pack.componentIds) {
+        auto& pool = componentPools[packComponentId];
+        pool->SwapIndices(pool->GetIndex(entityId), pack.size);
+    }
+    pack.size++;
+}
+
+void Registry::UnpackEntity(int entityId, int componentId) {
+    if (componentId >= static_cast<int>(packPerComponent.size()) || packPerComponent[componentId] == -1) {
+        return;
+    }
+    auto& pack = componentPacks[packPerComponent[componentId]];
+
+    // Only entities inside the packed range need to be moved out of it
+    const int index = componentPools[componentId]->GetIndex(entityId);
+    if (index == -1 || index >= pack.size) {
+        return;
+    }
+
+    for (auto packComponentId : pack.componentIds) {
+        auto& pool = componentPools[packComponentId];
+        pool->SwapIndices(pool->GetIndex(entityId), pack.size - 1);
+    }
+    pack.size--;
+}
+
+int Registry::GetTagId(const std::string& tag) {
+    return tagIds.emplace(tag, static_cast<int>(tagIds.size())).first->second;
+}
+
+int Registry::GetGroupId(const std::string& group) {
+    return groupIds.emplace(group, static_cast<int>(groupIds.size())).first->second;
+}
+
 void Registry::TagEntity(Entity entity, const std::string& tag) {
-    entityPerTag.emplace(tag, entity);
-    tagPerEntity.emplace(entity.GetId(), tag);
+    TagEntity(entity, GetTagId(tag));
 }
 
-bool Registry::EntityHasTag(Entity entity, const std::string& tag) const {
-    if (tagPerEntity.find(entity.GetId()) == tagPerEntity.end()) {
-        return false;
+void Registry::TagEntity(Entity entity, int tagId) {
+    // Like before, the first entity to get a tag keeps it, and an entity keeps its first tag
+    if (tagPerEntity[entity.GetId()] != -1) {
+        return;
+    }
+    if (entityPerTag.emplace(tagId, entity).second) {
+        tagPerEntity[entity.GetId()] = tagId;
     }
-    return entityPerTag.find(tag)->second == entity;
+}
+
+bool Registry::EntityHasTag(Entity entity, const std::string& tag) const {
+    auto tagId = tagIds.find(tag);
+    return tagId != tagIds.end() && EntityHasTag(entity, tagId->second);
+}
+
+bool Registry::EntityHasTag(Entity entity, int tagId) const {
+    return IsEntityAlive(entity) && tagPerEntity[entity.GetId()] == tagId;
 }
 
 Entity Registry::GetEntityByTag(const std::string& tag) const {
-    return entityPerTag.at(tag);
+    return entityPerTag.at(tagIds.at(tag));
 }
 
 void Registry::RemoveEntityTag(Entity entity) {
-    auto taggedEntity = tagPerEntity.find(entity.GetId());
-    if (taggedEntity != tagPerEntity.end()) {
-        auto tag = taggedEntity->second;
-        entityPerTag.erase(tag);
-        tagPerEntity.erase(taggedEntity);
+    auto& tagId = tagPerEntity[entity.GetId()];
+    if (tagId != -1) {
+        entityPerTag.erase(tagId);
+        tagId = -1;
     }
 }
 
 void Registry::GroupEntity(Entity entity, const std::string& group) {
-    entitiesPerGroup.emplace(group, std::set<Entity>());
-    entitiesPerGroup[group].emplace(entity);
-    groupPerEntity.emplace(entity.GetId(), group);
+    GroupEntity(entity, GetGroupId(group));
 }
 
-bool Registry::EntityBelongsToGroup(Entity entity, const std::string& group) const {
-    if (entitiesPerGroup.find(group) == entitiesPerGroup.end()) {
-        return false;
+void Registry::GroupEntity(Entity entity, int groupId) {
+    const auto entityId = entity.GetId();
+    if (groupPerEntity[entityId] == groupId) {
+        return;
     }
-    auto groupEntities = entitiesPerGroup.at(group);
-    return groupEntities.find(entity.GetId()) != groupEntities.end();
+    RemoveEntityGroup(entity);
+
+    if (groupId >= static_cast<int>(entitiesPerGroup.size())) {
+        entitiesPerGroup.resize(groupId + 1);
+    }
+    auto& groupEntities = entitiesPerGroup[groupId];
+    groupPerEntity[entityId] = groupId;
+    groupIndexPerEntity[entityId] = static_cast<int>(groupEntities.size());
+    groupEntities.push_back(entity);
+}
+
+bool Registry::EntityBelongsToGroup(Entity entity, const std::string& group) const {
+    auto groupId = groupIds.find(group);
+    return groupId != groupIds.end() && EntityBelongsToGroup(entity, groupId->second);
 }
 
-std::vector<Entity> Registry::GetEntitiesByGroup(const std::string& group) const {
-    auto& setOfEntities = entitiesPerGroup.at(group);
-    return std::vector<Entity>(setOfEntities.begin(), setOfEntities.end());
+bool Registry::EntityBelongsToGroup(Entity entity, int groupId) const {
+    return IsEntityAlive(entity) && groupPerEntity[entity.GetId()] == groupId;
+}
+
+const std::vector<Entity>& Registry::GetEntitiesByGroup(const std::string& group) const {
+    static const std::vector<Entity> noEntities;
+    auto groupId = groupIds.find(group);
+    return groupId != groupIds.end() ? GetEntitiesByGroup(groupId->second) : noEntities;
+}
+
+const std::vector<Entity>& Registry::GetEntitiesByGroup(int groupId) const {
+    static const std::vector<Entity> noEntities;
+    return groupId < static_cast<int>(entitiesPerGroup.size()) ? entitiesPerGroup[groupId] : noEntities;
 }
 
 void Registry::RemoveEntityGroup(Entity entity) {
-    // If in group, remove entity from group management
-    auto groupedEntity = groupPerEntity.find(entity.GetId());
-    if (groupedEntity != groupPerEntity.end()) {
-        auto group = entitiesPerGroup.find(groupedEntity->second);
-        if (group != entitiesPerGroup.end()) {
-            auto entityInGroup = group->second.find(entity);
-            if (entityInGroup != group->second.end()) {
-                group->second.erase(entityInGroup);
-            }
-        }
-        groupPerEntity.erase(groupedEntity);
+    // If in group, swap the last entity of the group into its place
+    const auto entityId = entity.GetId();
+    const auto groupId = groupPerEntity[entityId];
+    if (groupId == -1) {
+        return;
     }
+    auto& groupEntities = entitiesPerGroup[groupId];
+    const auto index = groupIndexPerEntity[entityId];
+    const Entity lastEntity = groupEntities.back();
+    groupEntities[index] = lastEntity;
+    groupIndexPerEntity[lastEntity.GetId()] = index;
+    groupEntities.pop_back();
+
+    groupPerEntity[entityId] = -1;
+    groupIndexPerEntity[entityId] = -1;
 }
 
 void Registry::Update() {
+    // Replay the recorded commands first, so their entities and components are processed below
+    for (auto& commandBuffer : commandBuffers) {
+        commandBuffer->Flush(*this);
+    }
+
+    // Process the entities that gained or lost components since the last update
+    for (auto entity : entitiesWithChangedSignature) {
+        const auto entityId = entity.GetId();
+        isEntitySignatureChanged[entityId] = false;
+
+        // Entities waiting to be created are matched with their final signature below
+        const auto& signature = entityComponentSignatures[entityId];
+        if (!isEntityToBeAdded[entityId]) {
+            UpdateEntitySystems(entity, previousComponentSignatures[entityId], signature);
+        }
+
+        // Release the pool entries of the components that were removed (and not added back)
+        auto& removedComponents = componentsToBeRemoved[entityId];
+        if (removedComponents.any()) {
+            for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+                if (removedComponents.test(componentId) && !signature.test(componentId)) {
+                    componentPools[componentId]->RemoveEntityFromPool(entityId);
+                }
+            }
+            removedComponents.reset();
+        }
+    }
+    entitiesWithChangedSignature.clear();
+
     // Process the entities that are waiting to be created to the active Systems
     for (auto entity : entitiesToBeAdded) {
+        isEntityToBeAdded[entity.GetId()] = false;
         AddEntityToSystems(entity);
     }
     entitiesToBeAdded.clear();
 
+    // Kills can be queued from parallel chunks in any order, so process them by entity id to keep
+    // the recycled ids (and everything spawned afterwards) independent of the thread count
+    std::sort(entitiesToBeKilled.begin(), entitiesToBeKilled.end(), [](const Entity& a, const Entity& b) {
+        return a.GetId() < b.GetId();
+    });
+
     // Process the entities that are waiting to be killed from the active Systems
     for (auto entity : entitiesToBeKilled) {
+        const auto entityId = entity.GetId();
+        isEntityToBeKilled[entityId] = false;
+
         RemoveEntityFromSystems(entity);
 
-        entityComponentSignatures[entity.GetId()].reset();
+        // Move the entity out of its component packs before the pools swap-remove it
+        for (auto& pack : componentPacks) {
+            UnpackEntity(entityId, pack.componentIds[0]);
+        }
+
+        // Instances of a recycling prefab keep the prefab components in the pools, so they can be
+        // reactivated by a later Instantiate() without going through the pools again
+        const Prefab* recyclingPrefab = recyclingPrefabPerEntity[entityId];
+        if (recyclingPrefab && !recyclingPrefab->IsRecycling()) {
+            recyclingPrefab = nullptr;
+        }
+        const Signature keptComponents = recyclingPrefab ? recyclingPrefab->GetSignature() : Signature();
 
-        // Remove the entity from the component pools
-        for (auto pool : componentPools) {
-            if (pool) {
-                pool->RemoveEntityFromPool(entity.GetId());
+        // Remove the entity from the component pools it has a component in
+        auto& signature = entityComponentSignatures[entityId];
+        for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+            if (signature.test(componentId) && !keptComponents.test(componentId)) {
+                componentPools[componentId]->RemoveEntityFromPool(entityId);
+            }
+        }
+
+        // Put back the prefab components the recycled entity lost while it was alive
+        if (recyclingPrefab) {
+            for (size_t componentId = 0; componentId < recyclingPrefab->components.size(); componentId++) {
+                if (keptComponents.test(componentId) && !signature.test(componentId)) {
+                    recyclingPrefab->components[componentId]->CopyTo(*this, &entity, 1);
+                }
             }
         }
+        signature.reset();
 
-        // Make the entity id available for re-use
-        freeIds.push_back(entity.GetId());
+        // Make the entity id available for re-use, with a new generation so old handles become stale
+        entityGenerations[entityId] = (entityGenerations[entityId] + 1) % MAX_ENTITY_GENERATION;
+        isEntityFree[entityId] = true;
+        if (recyclingPrefab) {
+            recycledEntitiesPerPrefab[recyclingPrefab].push_back(entityId);
+        }
+        else {
+            recyclingPrefabPerEntity[entityId] = nullptr;
+            freeIds.push_back(entityId);
+        }
 
         // Remove any traces of that entity from the tag/group maps
         RemoveEntityTag(entity);
@@ -184,4 +741,312 @@ void Registry::Update() {
     entitiesToBeKilled.clear();
 }
 
+void Registry::ClearEntities() {
+    numEntities = 0;
+    entityComponentSignatures.clear();
+    entityGenerations.clear();
+    entitiesToBeAdded.clear();
+    entitiesToBeKilled.clear();
+    isEntityToBeAdded.clear();
+    isEntityToBeKilled.clear();
+    entitiesWithChangedSignature.clear();
+    isEntitySignatureChanged.clear();
+    previousComponentSignatures.clear();
+    componentsToBeRemoved.clear();
+    entityPerTag.clear();
+    tagPerEntity.clear();
+    entitiesPerGroup.clear();
+    groupPerEntity.clear();
+    groupIndexPerEntity.clear();
+    freeIds.clear();
+    isEntityFree.clear();
+    recyclingPrefabPerEntity.clear();
+    recycledEntitiesPerPrefab.clear();
+
+    for (auto& pool : componentPools) {
+        if (pool) {
+            pool->Clear();
+        }
+    }
+    for (auto& pack : componentPacks) {
+        pack.size = 0;
+    }
+    for (auto& commandBuffer : commandBuffers) {
+        commandBuffer->Clear();
+    }
+    for (auto& system : systems) {
+        system.second->RemoveAllEntities();
+    }
+}
+
+void Registry::RebuildPacks() {
+    for (auto& pack : componentPacks) {
+        pack.size = 0;
+
+        // Scan the first pool in order, so a pool saved with its packed range in front is left as is
+        auto& firstPool = componentPools[pack.componentIds[0]];
+        for (int i = 0; i < firstPool->GetSize(); i++) {
+            const int entityId = firstPool->GetEntityIdAt(i);
+            if (entityComponentSignatures[entityId].Contains(pack.signature)) {
+                for (auto componentId : pack.componentIds) {
+                    auto& pool = componentPools[componentId];
+                    pool->SwapIndices(pool->GetIndex(entityId), pack.size);
+                }
+                pack.size++;
+            }
+        }
+    }
+}
+
+void Registry::SaveSnapshot(SnapshotWriter& writer) const {
+    // Most of the snapshot is the entity slots and the pool arrays
+    size_t estimatedSize = static_cast<size_t>(numEntities) * (sizeof(Signature) + sizeof(uint16_t) + sizeof(int32_t));
+    for (auto& stats : GetPoolStats()) {
+        estimatedSize += stats.usedBytes;
+    }
+    writer.Reserve(estimatedSize);
+
+    writer.Write(SNAPSHOT_MAGIC);
+    writer.Write(SNAPSHOT_VERSION);
+    writer.Write(static_cast<uint32_t>(Signature::NUM_BITS));
+
+    // Entity slots
+    writer.Write(static_cast<int32_t>(numEntities));
+    writer.WriteArray(entityGenerations.data(), numEntities);
+    writer.WriteArray(entityComponentSignatures.data(), numEntities);
+
+    // Recycled prefab instances are not tied to a prefab once loaded, so they are saved as free ids
+    std::vector<int32_t> savedFreeIds(freeIds.begin(), freeIds.end());
+    for (auto& recycledEntities : recycledEntitiesPerPrefab) {
+        savedFreeIds.insert(savedFreeIds.end(), recycledEntities.second.begin(), recycledEntities.second.end());
+    }
+    writer.Write(static_cast<int32_t>(savedFreeIds.size()));
+    writer.WriteArray(savedFreeIds.data(), savedFreeIds.size());
 
+    // Tags and groups are saved by name, their ids are only valid in this process
+    std::vector<std::string> tagNames(tagIds.size());
+    for (auto& tagId : tagIds) {
+        tagNames[tagId.second] = tagId.first;
+    }
+    writer.Write(static_cast<int32_t>(entityPerTag.size()));
+    for (auto& tag : entityPerTag) {
+        writer.Write(static_cast<int32_t>(tag.second.GetId()));
+        writer.WriteString(tagNames[tag.first]);
+    }
+
+    std::vector<std::string> groupNames(groupIds.size());
+    for (auto& groupId : groupIds) {
+        groupNames[groupId.second] = groupId.first;
+    }
+    const auto numGroups = std::count_if(entitiesPerGroup.begin(), entitiesPerGroup.end(), [](const std::vector<Entity>& groupEntities) {
+        return !groupEntities.empty();
+    });
+    writer.Write(static_cast<int32_t>(numGroups));
+    std::vector<int32_t> groupEntityIds;
+    for (size_t groupId = 0; groupId < entitiesPerGroup.size(); groupId++) {
+        const auto& groupEntities = entitiesPerGroup[groupId];
+        if (groupEntities.empty()) {
+            continue;
+        }
+        groupEntityIds.clear();
+        for (auto entity : groupEntities) {
+            groupEntityIds.push_back(entity.GetId());
+        }
+        writer.WriteString(groupNames[groupId]);
+        writer.Write(static_cast<int32_t>(groupEntityIds.size()));
+        writer.WriteArray(groupEntityIds.data(), groupEntityIds.size());
+    }
+
+    // Component pools, with the components that are left out dropped from the signatures on load
+    Signature savedComponents;
+    int numSavedPools = 0;
+    for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+        const auto& pool = componentPools[componentId];
+        if (!pool) {
+            continue;
+        }
+        if (pool->IsSerializable()) {
+            savedComponents.set(componentId);
+            numSavedPools++;
+        }
+        else if (pool->GetSize() > 0) {
+            Logger::Warn("Component id = ", componentId, " cannot be serialized and is left out of the snapshot");
+        }
+    }
+    writer.Write(savedComponents);
+    writer.Write(static_cast<int32_t>(numSavedPools));
+    for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+        if (savedComponents.test(componentId)) {
+            writer.Write(static_cast<int32_t>(componentId));
+            componentPools[componentId]->Save(writer);
+        }
+    }
+
+    Logger::Log("Registry snapshot saved with ", numEntities - static_cast<int>(savedFreeIds.size()), " entities, ", writer.GetBuffer().size(), " bytes");
+}
+
+bool Registry::SaveSnapshot(const std::string& filePath) const {
+    SnapshotWriter writer;
+    SaveSnapshot(writer);
+    return writer.SaveToFile(filePath);
+}
+
+bool Registry::LoadSnapshot(SnapshotReader& reader) {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t signatureBits;
+    if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(signatureBits) || magic != SNAPSHOT_MAGIC) {
+        Logger::Err("Not a registry snapshot");
+        return false;
+    }
+    if (version != SNAPSHOT_VERSION || signatureBits != Signature::NUM_BITS) {
+        Logger::Err("Registry snapshot version ", version, " with ", signatureBits, " signature bits cannot be loaded (expected version ", SNAPSHOT_VERSION, " with ", Signature::NUM_BITS, ")");
+        return false;
+    }
+
+    ClearEntities();
+    if (!ReadSnapshot(reader)) {
+        Logger::Err("Registry snapshot cannot be loaded, the registry was cleared");
+        ClearEntities();
+        return false;
+    }
+
+    Logger::Log("Registry snapshot loaded with ", numEntities - static_cast<int>(freeIds.size()), " entities");
+    return true;
+}
+
+bool Registry::LoadSnapshot(const std::string& filePath) {
+    SnapshotReader reader;
+    if (!reader.LoadFromFile(filePath)) {
+        return false;
+    }
+    return LoadSnapshot(reader);
+}
+
+bool Registry::ReadSnapshot(SnapshotReader& reader) {
+    // Entity slots
+    int32_t count;
+    if (!reader.Read(count) || count < 0 || count > static_cast<int32_t>(MAX_ENTITIES)) {
+        return false;
+    }
+    ResizeEntities(count);
+    numEntities = count;
+    if (!reader.ReadArray(entityGenerations.data(), count) || !reader.ReadArray(entityComponentSignatures.data(), count)) {
+        return false;
+    }
+    // A generation out of range would never match the handles made after the slot is reused
+    for (int entityId = 0; entityId < count; entityId++) {
+        if (entityGenerations[entityId] >= MAX_ENTITY_GENERATION) {
+            return false;
+        }
+    }
+
+    if (!reader.Read(count) || count < 0 || count > numEntities) {
+        return false;
+    }
+    std::vector<int32_t> savedFreeIds(count);
+    if (!reader.ReadArray(savedFreeIds.data(), count)) {
+        return false;
+    }
+    for (auto entityId : savedFreeIds) {
+        if (entityId < 0 || entityId >= numEntities || isEntityFree[entityId]) {
+            return false;
+        }
+        isEntityFree[entityId] = true;
+        entityComponentSignatures[entityId].reset();
+        freeIds.push_back(entityId);
+    }
+
+    // Tags and groups
+    if (!reader.Read(count) || count < 0) {
+        return false;
+    }
+    std::string name;
+    for (int i = 0; i < count; i++) {
+        int32_t entityId;
+        if (!reader.Read(entityId) || !reader.ReadString(name) || entityId < 0 || entityId >= numEntities || isEntityFree[entityId]) {
+            return false;
+        }
+        TagEntity(GetEntity(entityId), GetTagId(name));
+    }
+
+    if (!reader.Read(count) || count < 0) {
+        return false;
+    }
+    std::vector<int32_t> groupEntityIds;
+    for (int i = 0; i < count; i++) {
+        int32_t numGroupEntities;
+        if (!reader.ReadString(name) || !reader.Read(numGroupEntities) || numGroupEntities < 0 || numGroupEntities > numEntities) {
+            return false;
+        }
+        groupEntityIds.resize(numGroupEntities);
+        if (!reader.ReadArray(groupEntityIds.data(), numGroupEntities)) {
+            return false;
+        }
+        const int groupId = GetGroupId(name);
+        for (auto entityId : groupEntityIds) {
+            if (entityId < 0 || entityId >= numEntities || isEntityFree[entityId]) {
+                return false;
+            }
+            GroupEntity(GetEntity(entityId), groupId);
+        }
+    }
+
+    // Component pools, read straight into the packed arrays
+    Signature savedComponents;
+    if (!reader.Read(savedComponents) || !reader.Read(count) || count < 0) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        int32_t componentId;
+        if (!reader.Read(componentId) || componentId < 0 || componentId >= static_cast<int32_t>(Signature::NUM_BITS) || !savedComponents.test(componentId)) {
+            return false;
+        }
+        if (componentId >= static_cast<int>(componentPools.size()) || !componentPools[componentId] || !componentPools[componentId]->IsSerializable()) {
+            Logger::Err("Component id = ", componentId, " of the snapshot has no pool, register it with RegisterComponents()");
+            return false;
+        }
+        if (!componentPools[componentId]->Load(reader)) {
+            return false;
+        }
+    }
+
+    // Drop the components that were left out of the snapshot, and the pool entries that the signatures
+    // do not reference (components removed since the last update, and recycled prefab instances)
+    std::vector<int> numComponents(componentPools.size(), 0);
+    for (int entityId = 0; entityId < numEntities; entityId++) {
+        auto& signature = entityComponentSignatures[entityId];
+        signature &= savedComponents;
+        for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+            if (signature.test(componentId)) {
+                numComponents[componentId]++;
+            }
+        }
+    }
+    for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+        auto& pool = componentPools[componentId];
+        if (!pool) {
+            continue;
+        }
+        for (int i = pool->GetSize() - 1; i >= 0; i--) {
+            const int entityId = pool->GetEntityIdAt(i);
+            if (entityId >= numEntities || !entityComponentSignatures[entityId].test(componentId)) {
+                pool->RemoveEntityFromPool(entityId);
+            }
+        }
+
+        // Every component in a signature must have its pool entry
+        if (pool->GetSize() != numComponents[componentId]) {
+            return false;
+        }
+    }
+    RebuildPacks();
+
+    // Match every entity against the systems in a single pass
+    for (int entityId = 0; entityId < numEntities; entityId++) {
+        if (!isEntityFree[entityId]) {
+            AddEntityToSystems(GetEntity(entityId));
+        }
+    }
+    return true;
+}
@@ -1,68 +1,98 @@
 #pragma once
 #include "../Logger/Logger.h"
+#include "Signature.h"
+#include "MemoryArena.h"
+#include "Snapshot.h"
 #include <vector>
-#include <bitset>
-#include <set>
 #include <unordered_map>
 #include <typeindex>
 #include <memory>
+#include <cstdint>
+#include <mutex>
 #include <deque>
-
-const unsigned int MAX_COMPONENTS = 32;
-
-////////////////////////////////////////////////////////////////////////////////
-// Signature
-////////////////////////////////////////////////////////////////////////////////
-// We use a bitset (1s and 0s) to keep track of which components an entity has,
-// and also helps keep track of which entities a system is interested in.
-////////////////////////////////////////////////////////////////////////////////
-typedef std::bitset<MAX_COMPONENTS> Signature;
-
-struct IComponent {
-protected:
-    static int nextId;
-};
-
-// Used to assign a unique id to a component type
+#include <algorithm>
+#include <tuple>
+#include <cassert>
+
+const unsigned int MAX_COMPONENTS = Signature::NUM_BITS;
+
+// An entity handle packs the entity index (its slot in the registry) in the lower bits
+// and the generation of that slot in the upper bits
+const unsigned int ENTITY_INDEX_BITS = 20;
+const unsigned int ENTITY_GENERATION_BITS = 12;
+const unsigned int ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const unsigned int MAX_ENTITY_GENERATION = 1u << ENTITY_GENERATION_BITS;
+
+// The last entity index is never allocated, it marks the invalid handle returned when
+// the registry runs out of entity ids
+const unsigned int MAX_ENTITIES = ENTITY_INDEX_MASK;
+const unsigned int INVALID_ENTITY_ID = ENTITY_INDEX_MASK;
+
+// Used to get the unique id of a component type. Every component declares a
+// compile-time COMPONENT_ID (see Components/ComponentIds.h), so the ids are the
+// same on every run and can be read from any thread.
 template <typename T>
-class Component : public IComponent {
+class Component {
 public:
+    static_assert(T::COMPONENT_ID < MAX_COMPONENTS, "Component id does not fit in the signature, increase SIGNATURE_BITS");
+
     // Returns the unique id of Component<T>
-    static int GetId() {
-        static auto id = nextId++;
-        return id;
+    static constexpr int GetId() {
+        return T::COMPONENT_ID;
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Entity
+////////////////////////////////////////////////////////////////////////////////
+// An entity is a 32-bit generational handle. The generation of a slot changes
+// every time the slot is freed, so a handle kept across frames never aliases
+// a newly spawned entity that reuses the same index.
+// The handle does not store its registry: the Entity methods go through the
+// single live Registry, so only one Registry can exist at a time.
+////////////////////////////////////////////////////////////////////////////////
 class Entity {
 private:
-    int id;
+    uint32_t handle;
 
 public:
-    Entity(int id) : id(id) {};
+    Entity(int id, int generation = 0) : handle(static_cast<uint32_t>(id) | (static_cast<uint32_t>(generation) << ENTITY_INDEX_BITS)) {};
     Entity(const Entity& entity) = default;
     void Kill();
+    bool IsAlive() const;
+
+    // False for the handle returned when no entity could be created
+    bool IsValid() const;
+    static Entity Invalid();
+
+    // The entity id is the index of the entity slot, used to address signatures and pools
     int GetId() const;
+    int GetGeneration() const;
+    uint32_t GetHandle() const;
 
-    // Manage entity tags and groups
+    // Manage entity tags and groups, by name or by interned id (see Registry::GetTagId/GetGroupId)
     void Tag(const std::string& tag);
     bool HasTag(const std::string& tag) const;
+    bool HasTag(int tagId) const;
     void Group(const std::string& group);
     bool BelongsToGroup(const std::string& group) const;
+    bool BelongsToGroup(int groupId) const;
 
     Entity& operator =(const Entity& other) = default;
-    bool operator ==(const Entity& other) const { return id == other.id; }
-    bool operator !=(const Entity& other) const { return id != other.id; }
-    bool operator >(const Entity& other) const { return id > other.id; }
-    bool operator <(const Entity& other) const { return id < other.id; }
+    bool operator ==(const Entity& other) const { return handle == other.handle; }
+    bool operator !=(const Entity& other) const { return handle != other.handle; }
+    bool operator >(const Entity& other) const { return handle > other.handle; }
+    bool operator <(const Entity& other) const { return handle < other.handle; }
 
     template <typename TComponent, typename ...TArgs> void AddComponent(TArgs&& ...args);
     template <typename TComponent> void RemoveComponent();
     template <typename TComponent> bool HasComponent() const;
     template <typename TComponent> TComponent& GetComponent() const;
 
-    // Hold a pointer to the entity's owner registry
-    class Registry* registry;
+    // Pointer to the registry that owns the entities, shared by every handle
+    // so the handle itself stays 4 bytes (set by the Registry constructor,
+    // which asserts that no other registry exists)
+    static class Registry* registry;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,117 +105,330 @@ private:
     Signature componentSignature;
     std::vector<Entity> entities;
 
+    // Components the system update reads and writes, used by the scheduler to find out which
+    // systems can run concurrently. Exclusive systems (structural changes, Lua, audio) run alone.
+    Signature readSignature;
+    Signature writeSignature;
+    bool isExclusive = false;
+
+    // Position of each entity in the entities vector, so it can be swap-removed in O(1)
+    // [Vector index = entity id, -1 = entity is not in the system]
+    std::vector<int> entityIndices;
+
 public:
     System() = default;
     ~System() = default;
 
     void AddEntityToSystem(Entity entity);
     void RemoveEntityFromSystem(Entity entity);
-    std::vector<Entity> GetSystemEntities() const;
+    void RemoveAllEntities();
+
+    // Non-owning view of the system entities. The list is only changed by Registry::Update(),
+    // so entities created or killed while a system iterates it are applied on the next frame
+    const std::vector<Entity>& GetSystemEntities() const;
     const Signature& GetComponentSignature() const;
+    const Signature& GetReadSignature() const;
+    const Signature& GetWriteSignature() const;
+    bool IsExclusive() const;
 
     // Defines the component type that entities must have to be considered by the system
     template <typename TComponent> void RequireComponent();
+
+    // Declares the component types the system update reads or writes
+    template <typename TComponent> void ReadsComponent();
+    template <typename TComponent> void WritesComponent();
+    void SetExclusive(bool isExclusive);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 // Pool
 ////////////////////////////////////////////////////////////////////////////////
-// A pool is just a vector (contiguous data) of objects of type T
+// A pool is a sparse set: a packed vector (contiguous data) of objects of type T,
+// plus a paged sparse array that maps entity ids to indices in the packed vector.
+// All the pool memory comes from the memory arena given to its registry.
 ////////////////////////////////////////////////////////////////////////////////
+struct PoolStats {
+    int componentId;
+    const char* componentName;
+
+    // Number of objects, and number of objects that fit before the pool grows
+    int size;
+    int capacity;
+
+    // Bytes taken by the objects (and their entity ids), and bytes allocated by the pool
+    size_t usedBytes;
+    size_t reservedBytes;
+};
+
 class IPool {
 public:
     virtual ~IPool() = default;
     virtual void RemoveEntityFromPool(int entityId) = 0;
+    virtual int GetSize() const = 0;
+    virtual int GetIndex(int entityId) const = 0;
+    virtual int GetEntityIdAt(int index) const = 0;
+    virtual void SwapIndices(int indexA, int indexB) = 0;
+    virtual void Clear() = 0;
+    virtual void Trim() = 0;
+    virtual PoolStats GetStats() const = 0;
+
+    // Snapshot support: the packed arrays of the pool are written and read back in one go
+    virtual bool IsSerializable() const = 0;
+    virtual void Save(SnapshotWriter& writer) const = 0;
+    virtual bool Load(SnapshotReader& reader) = 0;
 };
 
 template <typename T>
 class Pool : public IPool {
 private:
-    // Keep track of the vector of objects and the current number of elements
-    std::vector<T> data;
-    int size;
+    MemoryArena& arena;
+
+    // Packed vector of objects, and the entity id that owns the object at each index
+    std::vector<T, ArenaAllocator<T>> data;
+    std::vector<int, ArenaAllocator<int>> indexToEntityId;
 
-    // Helper maps to keep track of entity ids per index, so the vector is always packed
-    std::unordered_map<int, int> entityIdToIndex;
-    std::unordered_map<int, int> indexToEntityId;
+    // Sparse array of indices per entity id, allocated in pages so a few high ids
+    // do not force a huge allocation [Page slot = entity id % PAGE_SIZE, -1 = no object]
+    static const int PAGE_SIZE = 1024;
+    std::vector<int*, ArenaAllocator<int*>> entityIdToIndex;
+    int numPages = 0;
+
+    // Capacity of a pool that grows without a Reserve()
+    static constexpr int MIN_CAPACITY = 16;
+
+    int* GetIndexSlot(int entityId) const {
+        const auto page = static_cast<size_t>(entityId / PAGE_SIZE);
+        if (page >= entityIdToIndex.size() || !entityIdToIndex[page]) {
+            return nullptr;
+        }
+        return &entityIdToIndex[page][entityId % PAGE_SIZE];
+    }
+
+    int& GetOrCreateIndexSlot(int entityId) {
+        const auto page = static_cast<size_t>(entityId / PAGE_SIZE);
+        if (page >= entityIdToIndex.size()) {
+            entityIdToIndex.resize(page + 1, nullptr);
+        }
+        if (!entityIdToIndex[page]) {
+            entityIdToIndex[page] = static_cast<int*>(arena.Allocate(PAGE_SIZE * sizeof(int), alignof(int)));
+            std::fill(entityIdToIndex[page], entityIdToIndex[page] + PAGE_SIZE, -1);
+            numPages++;
+        }
+        return entityIdToIndex[page][entityId % PAGE_SIZE];
+    }
+
+    void ReleasePage(size_t page) {
+        arena.Deallocate(entityIdToIndex[page], PAGE_SIZE * sizeof(int), alignof(int));
+        entityIdToIndex[page] = nullptr;
+        numPages--;
+    }
+
+    void ReleasePages() {
+        for (size_t page = 0; page < entityIdToIndex.size(); page++) {
+            if (entityIdToIndex[page]) {
+                ReleasePage(page);
+            }
+        }
+        entityIdToIndex.clear();
+    }
 
 public:
-    Pool(int capacity = 100) {
-        size = 0;
-        data.resize(capacity);
+    // The pool starts empty, so component types that are never used do not allocate anything
+    Pool(MemoryArena& arena = MemoryArena::GetDefault())
+        : arena(arena), data(ArenaAllocator<T>(arena)), indexToEntityId(ArenaAllocator<int>(arena)), entityIdToIndex(ArenaAllocator<int*>(arena)) {
     }
 
-    virtual ~Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator =(const Pool&) = delete;
+
+    virtual ~Pool() {
+        ReleasePages();
+    }
 
     bool IsEmpty() const {
-        return size == 0;
+        return data.empty();
     }
 
-    int GetSize() const {
-        return size;
+    int GetSize() const override {
+        return static_cast<int>(data.size());
     }
 
-    void Resize(int n) {
-        data.resize(n);
+    // Grows the capacity to at least n objects, at least doubling it so repeated small
+    // reserves do not reallocate every time
+    void Reserve(int n) {
+        if (n <= static_cast<int>(data.capacity())) {
+            return;
+        }
+        const int capacity = std::max(n, static_cast<int>(data.capacity()) * 2);
+        data.reserve(capacity);
+        indexToEntityId.reserve(capacity);
     }
 
-    void Clear() {
+    void Clear() override {
         data.clear();
-        size = 0;
+        indexToEntityId.clear();
+        ReleasePages();
+    }
+
+    // Gives the capacity above the current size back to the arena, and the sparse pages that
+    // no longer hold any object
+    void Trim() override {
+        data.shrink_to_fit();
+        indexToEntityId.shrink_to_fit();
+
+        for (size_t page = 0; page < entityIdToIndex.size(); page++) {
+            const int* indices = entityIdToIndex[page];
+            if (indices && std::all_of(indices, indices + PAGE_SIZE, [](int index) { return index == -1; })) {
+                ReleasePage(page);
+            }
+        }
+        while (!entityIdToIndex.empty() && !entityIdToIndex.back()) {
+            entityIdToIndex.pop_back();
+        }
+        entityIdToIndex.shrink_to_fit();
     }
 
-    void Add(T object) {
-        data.push_back(object);
+    PoolStats GetStats() const override {
+        PoolStats stats;
+        stats.componentId = Component<T>::GetId();
+        stats.componentName = typeid(T).name();
+        stats.size = GetSize();
+        stats.capacity = static_cast<int>(data.capacity());
+        stats.usedBytes = data.size() * (sizeof(T) + sizeof(int));
+        stats.reservedBytes = data.capacity() * sizeof(T) + indexToEntityId.capacity() * sizeof(int) +
+            entityIdToIndex.capacity() * sizeof(int*) + numPages * PAGE_SIZE * sizeof(int);
+        return stats;
     }
 
-    void Set(int entityId, T object) {
-        // If the element already exists, simply replace the component object
-        if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
-            int index = entityIdToIndex[entityId];
-            data[index] = object;
+    bool IsSerializable() const override {
+        return ComponentSerializer<T>::IS_SERIALIZABLE;
+    }
+
+    void Save(SnapshotWriter& writer) const override {
+        if constexpr (ComponentSerializer<T>::IS_SERIALIZABLE) {
+            const int size = GetSize();
+            writer.Write(static_cast<int32_t>(size));
+            writer.WriteArray(indexToEntityId.data(), size);
+            ComponentSerializer<T>::Write(writer, data.data(), size);
         }
-        else {
-            // When adding a new object, always add at the end
-            int index = size;
-            entityIdToIndex.emplace(entityId, index);
-            indexToEntityId.emplace(index, entityId);
-
-            if (index >= data.capacity()) {
-                // If necessary, we resize by always doubling the current capacity
-                data.resize(size * 2);
+    }
+
+    // Replaces the content of the pool, keeping the packed order of the snapshot
+    bool Load(SnapshotReader& reader) override {
+        Clear();
+        if constexpr (ComponentSerializer<T>::IS_SERIALIZABLE) {
+            int32_t size;
+            if (!reader.Read(size) || size < 0 || size > static_cast<int32_t>(MAX_ENTITIES)) {
+                return false;
+            }
+            // The count comes from the file, check it before allocating the components
+            if (static_cast<size_t>(size) * (sizeof(int32_t) + ComponentSerializer<T>::MIN_BYTES) > reader.GetRemainingSize()) {
+                return false;
+            }
+            Reserve(size);
+            indexToEntityId.resize(size);
+            data.resize(size);
+            if (!reader.ReadArray(indexToEntityId.data(), size) || !ComponentSerializer<T>::Read(reader, data.data(), size)) {
+                Clear();
+                return false;
             }
-            data[index] = object;
-            size++;
+            for (int index = 0; index < size; index++) {
+                const int entityId = indexToEntityId[index];
+                if (entityId < 0 || entityId >= static_cast<int>(MAX_ENTITIES) || Contains(entityId)) {
+                    Clear();
+                    return false;
+                }
+                GetOrCreateIndexSlot(entityId) = index;
+            }
+            return true;
         }
+        return false;
     }
 
-    void Remove(int entityId) {
-        // Copy the last element to the deleted position to keep the array packed
-        int indexOfRemoved = entityIdToIndex[entityId];
-        int indexOfLast = size - 1;
-        data[indexOfRemoved] = data[indexOfLast];
+    bool Contains(int entityId) const {
+        const int* slot = GetIndexSlot(entityId);
+        return slot && *slot != -1;
+    }
+
+    // Construct the object in place, replacing the existing object if the entity already has one
+    template <typename ...TArgs>
+    T& Emplace(int entityId, TArgs&& ...args) {
+        int& index = GetOrCreateIndexSlot(entityId);
+        if (index != -1) {
+            data[index] = T(std::forward<TArgs>(args)...);
+            return data[index];
+        }
+
+        // When adding a new object, always add at the end
+        if (data.size() == data.capacity()) {
+            Reserve(std::max(MIN_CAPACITY, static_cast<int>(data.size()) + 1));
+        }
+        index = static_cast<int>(data.size());
+        data.emplace_back(std::forward<TArgs>(args)...);
+        indexToEntityId.push_back(entityId);
+        return data.back();
+    }
 
-        // Update the index-entity maps to point to the correct elements
-        int entityIdOfLastElement = indexToEntityId[indexOfLast];
-        entityIdToIndex[entityIdOfLastElement] = indexOfRemoved;
-        indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
+    void Set(int entityId, const T& object) {
+        Emplace(entityId, object);
+    }
 
-        entityIdToIndex.erase(entityId);
-        indexToEntityId.erase(indexOfLast);
+    void Set(int entityId, T&& object) {
+        Emplace(entityId, std::move(object));
+    }
 
-        size--;
+    void Remove(int entityId) {
+        int& indexOfRemoved = *GetIndexSlot(entityId);
+        const int indexOfLast = static_cast<int>(data.size()) - 1;
+
+        // Move the last element to the deleted position to keep the array packed
+        if (indexOfRemoved != indexOfLast) {
+            const int entityIdOfLastElement = indexToEntityId[indexOfLast];
+            data[indexOfRemoved] = std::move(data[indexOfLast]);
+            indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
+            *GetIndexSlot(entityIdOfLastElement) = indexOfRemoved;
+        }
+
+        data.pop_back();
+        indexToEntityId.pop_back();
+        indexOfRemoved = -1;
     }
 
     void RemoveEntityFromPool(int entityId) override {
-        if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
+        if (Contains(entityId)) {
             Remove(entityId);
         }
     }
 
+    // The entity must have an object in the pool (see Contains)
     T& Get(int entityId) {
-        int index = entityIdToIndex[entityId];
-        return static_cast<T&>(data[index]);
+        const int* slot = GetIndexSlot(entityId);
+        assert(slot && *slot != -1 && "Entity has no object in the pool");
+        return data[*slot];
+    }
+
+    int GetIndex(int entityId) const override {
+        const int* slot = GetIndexSlot(entityId);
+        return slot ? *slot : -1;
+    }
+
+    // Swap two objects in the packed vector, keeping the entity-index mapping in sync
+    void SwapIndices(int indexA, int indexB) override {
+        if (indexA == indexB) {
+            return;
+        }
+        std::swap(data[indexA], data[indexB]);
+        std::swap(indexToEntityId[indexA], indexToEntityId[indexB]);
+        *GetIndexSlot(indexToEntityId[indexA]) = indexA;
+        *GetIndexSlot(indexToEntityId[indexB]) = indexB;
+    }
+
+    int GetEntityId(int index) const {
+        return indexToEntityId[index];
+    }
+
+    int GetEntityIdAt(int index) const override {
+        return indexToEntityId[index];
     }
 
     T& operator [](unsigned int index) {
@@ -193,16 +436,122 @@ public:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// ComponentPack
+////////////////////////////////////////////////////////////////////////////////
+// A pack is the optional archetype-like storage mode of the registry. The entities
+// that have all the components of a pack are kept at the front of each of the
+// pack pools, in the same order, so a system can walk those pools side by side
+// as plain contiguous arrays. A component type can only belong to one pack.
+////////////////////////////////////////////////////////////////////////////////
+struct ComponentPack {
+    Signature signature;
+    std::vector<int> componentIds;
+
+    // Number of packed entities [Pool index 0 .. size-1 of every pack pool]
+    int size = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ComponentView
+////////////////////////////////////////////////////////////////////////////////
+// A view iterates the entities that have all the given components, handing out
+// references straight from the pools. The pool pointers are resolved once when
+// the view is created, and the iteration walks the smallest of the pools (or the
+// packed range, when all the components belong to the same component pack).
+////////////////////////////////////////////////////////////////////////////////
+template <typename ...TComponents>
+class ComponentView {
+private:
+    const std::vector<Signature>* entityComponentSignatures;
+    const std::vector<uint16_t>* entityGenerations;
+    Signature signature;
+    std::tuple<Pool<TComponents>*...> pools;
+
+    // Number of packed entities, or -1 if the components are not packed together
+    int packedSize;
+
+    // Pool walked by the view when the components are not packed (the smallest one)
+    const IPool* iterationPool = nullptr;
+
+    bool HasAllPools() const {
+        return ((std::get<Pool<TComponents>*>(pools) != nullptr) && ...);
+    }
+
+public:
+    ComponentView(const std::vector<Signature>* entityComponentSignatures, const std::vector<uint16_t>* entityGenerations, const Signature& signature, int packedSize, Pool<TComponents>* ...pools)
+        : entityComponentSignatures(entityComponentSignatures), entityGenerations(entityGenerations), signature(signature), pools(pools...), packedSize(packedSize) {
+        if (!HasAllPools() || packedSize != -1) {
+            return;
+        }
+        const IPool* candidates[] = { pools... };
+        for (auto candidate : candidates) {
+            if (iterationPool == nullptr || candidate->GetSize() < iterationPool->GetSize()) {
+                iterationPool = candidate;
+            }
+        }
+    }
+
+    // Number of slots the view walks; Each(func, begin, end) accepts any sub-range of [0, GetSize())
+    int GetSize() const {
+        if (!HasAllPools()) {
+            return 0;
+        }
+        return packedSize != -1 ? packedSize : iterationPool->GetSize();
+    }
+
+    // Invokes func(Entity, TComponents&...) for every entity that has all the components
+    template <typename TFunc>
+    void Each(TFunc&& func) const {
+        Each(std::forward<TFunc>(func), 0, GetSize());
+    }
+
+    // Same as above, restricted to the slots [begin, end) so disjoint ranges can run on different threads
+    template <typename TFunc>
+    void Each(TFunc&& func, int begin, int end) const {
+        if (!HasAllPools()) {
+            return;
+        }
+
+        // Packed components are aligned, so the same index addresses the same entity in every pool
+        if (packedSize != -1) {
+            auto& firstPool = *std::get<0>(pools);
+            for (int i = begin; i < end; i++) {
+                const int entityId = firstPool.GetEntityId(i);
+                Entity entity(entityId, (*entityGenerations)[entityId]);
+                func(entity, (*std::get<Pool<TComponents>*>(pools))[i]...);
+            }
+            return;
+        }
+
+        // Otherwise walk the smallest pool and check the other components with the entity signature
+        for (int i = begin; i < end; i++) {
+            const int entityId = iterationPool->GetEntityIdAt(i);
+            if (!(*entityComponentSignatures)[entityId].Contains(signature)) {
+                continue;
+            }
+            Entity entity(entityId, (*entityGenerations)[entityId]);
+            func(entity, std::get<Pool<TComponents>*>(pools)->Get(entityId)...);
+        }
+    }
+};
+
+class CommandBuffer;
+class Prefab;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Registry
 ////////////////////////////////////////////////////////////////////////////////
 // The registry manages the creation and destruction of entities, add systems,
-// and components.
+// and components. Only one registry can exist at a time (see Entity).
 ////////////////////////////////////////////////////////////////////////////////
 class Registry {
 private:
     int numEntities = 0;
 
+    // Arena every component pool allocates from
+    MemoryArena& memoryArena;
+
     // Vector of component pools, each pool contains all the data for a certain compoenent type
     // [Vector index = component type id]
     // [Pool index = entity id]
@@ -212,53 +561,163 @@ private:
     // [Vector index = entity id]
     std::vector<Signature> entityComponentSignatures;
 
+    // Current generation of each entity slot, bumped when the slot is freed
+    // [Vector index = entity id]
+    std::vector<uint16_t> entityGenerations;
+
     // Map of active systems
     // [Map key = system type id]
     std::unordered_map<std::type_index, std::shared_ptr<System>> systems;
 
-    // Set of entities that are flagged to be added or removed in the next registry Update()
-    std::set<Entity> entitiesToBeAdded;
-    std::set<Entity> entitiesToBeKilled;
+    // Entities that are flagged to be added or removed in the next registry Update(),
+    // with one bit per entity id so each entity is queued only once
+    // [Bit index = entity id]
+    std::vector<Entity> entitiesToBeAdded;
+    std::vector<Entity> entitiesToBeKilled;
+    std::vector<bool> isEntityToBeAdded;
+    std::vector<bool> isEntityToBeKilled;
+
+    // Systems running on worker threads can kill entities concurrently
+    std::mutex killMutex;
+
+    // Entities that gained or lost components since the last registry Update(), with the
+    // signature the systems last matched them against, and the components whose pool
+    // entries are released on the next Update() [Vector index = entity id]
+    std::vector<Entity> entitiesWithChangedSignature;
+    std::vector<bool> isEntitySignatureChanged;
+    std::vector<Signature> previousComponentSignatures;
+    std::vector<Signature> componentsToBeRemoved;
+
+    // Tag and group names are interned to small ids shared by every registry
+    static std::unordered_map<std::string, int> tagIds;
+    static std::unordered_map<std::string, int> groupIds;
+
+    // Entity tags (one tag per entity)
+    // [Map key = tag id] [Vector index = entity id, -1 = no tag]
+    std::unordered_map<int, Entity> entityPerTag;
+    std::vector<int> tagPerEntity;
+
+    // Entity groups (one group per entity), with the entities of each group packed together
+    // [Vector index = group id] [Vector index = entity id, -1 = no group]
+    std::vector<std::vector<Entity>> entitiesPerGroup;
+    std::vector<int> groupPerEntity;
+    std::vector<int> groupIndexPerEntity;
+
+    // List of free entity ids that were previously removed, and whether each entity slot is
+    // free (including the recycled prefab instances) [Vector index = entity id]
+    std::deque<int> freeIds;
+    std::vector<bool> isEntityFree;
 
-    // Entity tags (one tag name per entity)
-    std::unordered_map<std::string, Entity> entityPerTag;
-    std::unordered_map<int, std::string> tagPerEntity;
+    // Component packs, and the pack each component type belongs to
+    // [Vector index = component type id, -1 = component is not packed]
+    std::vector<ComponentPack> componentPacks;
+    std::vector<int> packPerComponent;
 
-    // Entity groups (a set of entities per group name)
-    std::unordered_map<std::string, std::set<Entity>> entitiesPerGroup;
-    std::unordered_map<int, std::string> groupPerEntity;
+    // Command buffers, flushed in the order they were created at the start of Update()
+    std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
 
-    // List of free entity ids that were previously removed
-    std::deque<int> freeIds;
+    // Prefabs by name
+    std::unordered_map<std::string, std::unique_ptr<Prefab>> prefabs;
 
-public:
-    Registry() {
-        Logger::Log("Registry constructor called");
-    }
+    // Recycling prefab each entity was instantiated from, and the killed instances of each
+    // recycling prefab, which keep their components until they are instantiated again
+    // [Vector index = entity id, nullptr = the entity id is freed when the entity is killed]
+    std::vector<const Prefab*> recyclingPrefabPerEntity;
+    std::unordered_map<const Prefab*, std::vector<int>> recycledEntitiesPerPrefab;
 
-    ~Registry() {
-        Logger::Log("Registry destructor called");
-    }
+    template <typename TComponent> Pool<TComponent>* GetOrCreatePool();
+    template <typename TComponent> Pool<TComponent>* GetPool() const;
+
+    // Move the entity into (or out of) the packed range of the pack that owns the component
+    void PackEntity(int entityId, int componentId);
+    void UnpackEntity(int entityId, int componentId);
+
+    // Queue the entity to be re-matched against the systems in the next Update()
+    void OnSignatureChanged(Entity entity, const Signature& oldSignature);
+
+    // Takes a free entity id and queues the entity to be added, without logging.
+    // Returns an invalid entity when every entity id is in use.
+    Entity AllocateEntity();
+
+    // Grows the per-entity data once for count more entities
+    void ReserveEntities(int count);
+
+    // Grows the per-entity data to hold count entity ids
+    void ResizeEntities(int count);
+
+    // Removes every entity, component, tag, group and pending change, keeping the pools, packs and systems
+    void ClearEntities();
+
+    // Moves the entities that have all the components of each pack to the front of the pack pools
+    void RebuildPacks();
+
+    // Reads everything after the snapshot header into the cleared registry
+    bool ReadSnapshot(SnapshotReader& reader);
+
+    // Adds the component to the entity without logging
+    template <typename TComponent, typename ...TArgs> void EmplaceComponent(Entity entity, TArgs&& ...args);
+
+    // Type-erased component removal, used when replaying command buffers
+    void RemoveComponent(Entity entity, int componentId);
+
+    // Copies the component value to the pool of every entity, without touching their signatures
+    template <typename TComponent> void CopyComponent(const TComponent& component, const Entity* entities, int count);
+
+    // Appends count instances of the prefab to entities, reactivating its recycled instances first.
+    // The instances that could not be created are appended as invalid entities.
+    void InstantiateEntities(const Prefab& prefab, int count, std::vector<Entity>& entities);
+
+    // Frees the recycled instances of the prefab, with their components
+    void ReleaseRecycledEntities(const Prefab& prefab);
+
+    friend class CommandBuffer;
+    friend class Prefab;
+
+public:
+    Registry(MemoryArena& memoryArena = MemoryArena::GetDefault());
+    ~Registry();
 
     // The registry Update() finally processes the entities that are waiting to be added/killed to the systems
     void Update();
 
-    // Entity management
+    // Entity management. Returns an invalid entity (see Entity::IsValid) when every entity id is in use.
     Entity CreateEntity();
 
+    // Creates count entities at once, growing the per-entity data a single time. Returns fewer
+    // entities when the entity ids run out.
+    std::vector<Entity> CreateEntities(int count);
+
     // Kill entity
     void KillEntity(Entity entity);
 
+    // Returns true if the handle still refers to a live entity (its slot was not freed since).
+    // A killed entity stays alive until the next Update() processes the kill.
+    bool IsEntityAlive(Entity entity) const;
+
+    // Returns the handle of the entity that currently occupies the given slot
+    Entity GetEntity(int entityId) const;
+
+    // Returns the id of a tag or group name, interning it the first time. Intern the names at
+    // load time (e.g. in the system constructors): the tables are not guarded against
+    // concurrent insertions.
+    static int GetTagId(const std::string& tag);
+    static int GetGroupId(const std::string& group);
+
     // Tag management
     void TagEntity(Entity entity, const std::string& tag);
+    void TagEntity(Entity entity, int tagId);
     bool EntityHasTag(Entity entity, const std::string& tag) const;
+    bool EntityHasTag(Entity entity, int tagId) const;
     Entity GetEntityByTag(const std::string& tag) const;
     void RemoveEntityTag(Entity entity);
 
     // Group management
     void GroupEntity(Entity entity, const std::string& group);
+    void GroupEntity(Entity entity, int groupId);
     bool EntityBelongsToGroup(Entity entity, const std::string& group) const;
-    std::vector<Entity> GetEntitiesByGroup(const std::string& group) const;
+    bool EntityBelongsToGroup(Entity entity, int groupId) const;
+    const std::vector<Entity>& GetEntitiesByGroup(const std::string& group) const;
+    const std::vector<Entity>& GetEntitiesByGroup(int groupId) const;
     void RemoveEntityGroup(Entity entity);
 
     // Component management
@@ -267,6 +726,60 @@ public:
     template <typename TComponent> bool HasComponent(Entity entity) const;
     template <typename TComponent> TComponent& GetComponent(Entity entity) const;
 
+    // Copies components[i] to entities[i], reserving the pool once for the whole batch
+    template <typename TComponent> void AddComponents(const std::vector<Entity>& entities, const std::vector<TComponent>& components);
+
+    // Make room for count more components of the given type
+    template <typename TComponent> void ReserveComponents(int count);
+
+    // Gives the unused pool capacity back to the memory arena, e.g. after a level was unloaded
+    // (and its entities were killed by an Update())
+    void TrimPools();
+
+    // Creates the pools of the component types up front, e.g. so a snapshot can be loaded into a new registry
+    template <typename ...TComponents> void RegisterComponents();
+
+    // Snapshots are a versioned binary copy of every entity, component pool, tag and group, used for
+    // save games or to warm-start a scenario without the level loader. Save between frames (after
+    // Update()). Loading replaces the whole content of the registry, drops the pending commands,
+    // and needs the pool of every component type in the snapshot (see RegisterComponents()).
+    // Components that cannot be serialized (e.g. scripts) are left out, and recycled prefab
+    // instances are saved as free entity ids.
+    void SaveSnapshot(SnapshotWriter& writer) const;
+    bool SaveSnapshot(const std::string& filePath) const;
+    bool LoadSnapshot(SnapshotReader& reader);
+    bool LoadSnapshot(const std::string& filePath);
+
+    // Size, capacity and memory of every component pool
+    std::vector<PoolStats> GetPoolStats() const;
+    void LogPoolStats() const;
+    MemoryArena& GetMemoryArena() const;
+
+    // Query the entities that have all the given components
+    template <typename ...TComponents> ComponentView<TComponents...> View();
+
+    // Component pack management
+    template <typename ...TComponents> void AddPack();
+
+    // Prefab management. Prefabs live as long as the registry: creating a prefab with the name of
+    // an existing one clears and returns the existing prefab, so references to it stay valid
+    Prefab& CreatePrefab(const std::string& name);
+    Prefab* GetPrefab(const std::string& name) const;
+
+    // Creates entities with all the components, tag and group of the prefab. A reactivated
+    // instance of a recycling prefab keeps the component values it had when it was killed,
+    // the caller sets the ones that change (e.g. the transform). Like CreateEntity(), returns
+    // an invalid entity or fewer entities when the entity ids run out.
+    Entity Instantiate(const Prefab& prefab);
+    std::vector<Entity> Instantiate(const Prefab& prefab, int count);
+
+    // Frees the recycled instances of every prefab, e.g. before trimming the pools
+    void ReleaseRecycledEntities();
+
+    // Creates a command buffer that records structural changes to be applied in the next Update().
+    // A buffer must only be recorded by one thread at a time: give each job its own buffer.
+    CommandBuffer& CreateCommandBuffer();
+
     // System management
     template <typename TSystem, typename ...TArgs> void AddSystem(TArgs&& ...args);
     template <typename TSystem> void RemoveSystem();
@@ -276,6 +789,9 @@ public:
     // Add and remove entity from their systems
     void AddEntityToSystems(Entity entity);
     void RemoveEntityFromSystems(Entity entity);
+
+    // Only re-evaluate the systems that require one of the components that changed
+    void UpdateEntitySystems(Entity entity, const Signature& oldSignature, const Signature& newSignature);
 };
 
 template <typename TComponent>
@@ -284,6 +800,16 @@ void System::RequireComponent() {
     componentSignature.set(componentId);
 }
 
+template <typename TComponent>
+void System::ReadsComponent() {
+    readSignature.set(Component<TComponent>::GetId());
+}
+
+template <typename TComponent>
+void System::WritesComponent() {
+    writeSignature.set(Component<TComponent>::GetId());
+}
+
 template <typename TSystem, typename ...TArgs>
 void Registry::AddSystem(TArgs&& ...args) {
     std::shared_ptr<TSystem> newSystem = std::make_shared<TSystem>(std::forward<TArgs>(args)...);
@@ -307,10 +833,9 @@ TSystem& Registry::GetSystem() const {
     return *(std::static_pointer_cast<TSystem>(system->second));
 }
 
-template <typename TComponent, typename ...TArgs>
-void Registry::AddComponent(Entity entity, TArgs&& ...args) {
+template <typename TComponent>
+Pool<TComponent>* Registry::GetOrCreatePool() {
     const auto componentId = Component<TComponent>::GetId();
-    const auto entityId = entity.GetId();
 
     // If componentId is greater than the current size of the componentPools, resize the vector
     if (componentId >= componentPools.size()) {
@@ -319,38 +844,91 @@ void Registry::AddComponent(Entity entity, TArgs&& ...args) {
 
     // If there is no pool, create a new pool for that component type
     if (!componentPools[componentId]) {
-        std::shared_ptr<Pool<TComponent>> newComponentPool(new Pool<TComponent>());
+        std::shared_ptr<Pool<TComponent>> newComponentPool(new Pool<TComponent>(memoryArena));
         componentPools[componentId] = newComponentPool;
     }
 
-    // Get the pool of component values for that component type
-    std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
+    return static_cast<Pool<TComponent>*>(componentPools[componentId].get());
+}
+
+template <typename TComponent>
+Pool<TComponent>* Registry::GetPool() const {
+    const auto componentId = Component<TComponent>::GetId();
+    if (componentId >= componentPools.size()) {
+        return nullptr;
+    }
+    return static_cast<Pool<TComponent>*>(componentPools[componentId].get());
+}
 
-    // Create a new Component object of the type T, and foward the various parameters to the constructor of the component
-    TComponent newComponent(std::forward<TArgs>(args)...);
+template <typename TComponent, typename ...TArgs>
+void Registry::EmplaceComponent(Entity entity, TArgs&& ...args) {
+    const auto componentId = Component<TComponent>::GetId();
+    const auto entityId = entity.GetId();
 
-    // Add the new component to the component pool, using the entity id as index
-    componentPool->Set(entityId, newComponent);
+    // Get the pool of component values for that component type
+    Pool<TComponent>* componentPool = GetOrCreatePool<TComponent>();
+
+    // Construct the new component in place, fowarding the various parameters to the constructor of the component
+    componentPool->Emplace(entityId, std::forward<TArgs>(args)...);
 
     // Turn on the component signature -> The entity has this component
+    const Signature oldSignature = entityComponentSignatures[entityId];
     entityComponentSignatures[entityId].set(componentId);
 
-    Logger::Log("Component id = " + std::to_string(componentId) + " was added to entity id " + std::to_string(entityId));
+    PackEntity(entityId, componentId);
+
+    if (!oldSignature.test(componentId)) {
+        OnSignatureChanged(entity, oldSignature);
+    }
+}
+
+template <typename TComponent, typename ...TArgs>
+void Registry::AddComponent(Entity entity, TArgs&& ...args) {
+    EmplaceComponent<TComponent>(entity, std::forward<TArgs>(args)...);
+    Logger::Debug("Component id = ", Component<TComponent>::GetId(), " was added to entity id ", entity.GetId());
+}
+
+template <typename TComponent>
+void Registry::AddComponents(const std::vector<Entity>& entities, const std::vector<TComponent>& components) {
+    if (entities.size() != components.size()) {
+        Logger::Err("Cannot add ", components.size(), " components to ", entities.size(), " entities");
+        return;
+    }
+    if (entities.empty()) {
+        return;
+    }
+
+    ReserveComponents<TComponent>(static_cast<int>(components.size()));
+    for (size_t i = 0; i < entities.size(); i++) {
+        EmplaceComponent<TComponent>(entities[i], components[i]);
+    }
+
+    Logger::Log("Component id = ", Component<TComponent>::GetId(), " was added to ", entities.size(), " entities");
 }
 
 template <typename TComponent>
 void Registry::RemoveComponent(Entity entity) {
-    const auto componentId = Component<TComponent>::GetId();
-    const auto entityId = entity.GetId();
+    RemoveComponent(entity, Component<TComponent>::GetId());
+}
 
-    // Remove the component from the component list for that entity
-    std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
-    componentPool->Remove(entityId);
+template <typename TComponent>
+void Registry::ReserveComponents(int count) {
+    Pool<TComponent>* componentPool = GetOrCreatePool<TComponent>();
+    componentPool->Reserve(componentPool->GetSize() + count);
+}
 
-    // Turn off the component signature -> The entity no longer has this component
-    entityComponentSignatures[entityId].set(componentId, false);
+template <typename ...TComponents>
+void Registry::RegisterComponents() {
+    (GetOrCreatePool<TComponents>(), ...);
+}
 
-    Logger::Log("Component id = " + std::to_string(componentId) + " was removed from entity id " + std::to_string(entityId));
+template <typename TComponent>
+void Registry::CopyComponent(const TComponent& component, const Entity* entities, int count) {
+    Pool<TComponent>* componentPool = GetOrCreatePool<TComponent>();
+    componentPool->Reserve(componentPool->GetSize() + count);
+    for (int i = 0; i < count; i++) {
+        componentPool->Emplace(entities[i].GetId(), component);
+    }
 }
 
 template <typename TComponent>
@@ -364,8 +942,64 @@ template <typename TComponent>
 TComponent& Registry::GetComponent(Entity entity) const {
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
-    auto componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
-    return componentPool->Get(entityId);
+    return static_cast<Pool<TComponent>*>(componentPools[componentId].get())->Get(entityId);
+}
+
+template <typename ...TComponents>
+ComponentView<TComponents...> Registry::View() {
+    Signature signature;
+    (signature.set(Component<TComponents>::GetId()), ...);
+
+    // Use the packed range when all the components belong to the same pack
+    int packedSize = -1;
+    const int firstComponentId = std::get<0>(std::make_tuple(Component<TComponents>::GetId()...));
+    if (firstComponentId < packPerComponent.size() && packPerComponent[firstComponentId] != -1) {
+        const auto& pack = componentPacks[packPerComponent[firstComponentId]];
+        if (pack.signature.Contains(signature)) {
+            packedSize = pack.size;
+        }
+    }
+
+    return ComponentView<TComponents...>(&entityComponentSignatures, &entityGenerations, signature, packedSize, GetPool<TComponents>()...);
+}
+
+template <typename ...TComponents>
+void Registry::AddPack() {
+    const std::vector<int> componentIds = { Component<TComponents>::GetId()... };
+
+    // Make sure every pool exists, and none of them already belongs to another pack
+    std::vector<IPool*> pools = { GetOrCreatePool<TComponents>()... };
+    if (packPerComponent.size() < componentPools.size()) {
+        packPerComponent.resize(componentPools.size(), -1);
+    }
+    for (auto componentId : componentIds) {
+        if (packPerComponent[componentId] != -1) {
+            Logger::Err("Component id = ", componentId, " already belongs to a component pack");
+            return;
+        }
+    }
+
+    ComponentPack pack;
+    for (auto componentId : componentIds) {
+        pack.signature.set(componentId);
+        packPerComponent[componentId] = static_cast<int>(componentPacks.size());
+    }
+    pack.componentIds = componentIds;
+
+    // Pack the entities that already have all the components, scanning the first pool
+    auto& firstPool = *static_cast<Pool<std::tuple_element_t<0, std::tuple<TComponents...>>>*>(pools[0]);
+    for (int i = 0; i < firstPool.GetSize(); i++) {
+        const int entityId = firstPool.GetEntityId(i);
+        if (entityComponentSignatures[entityId].Contains(pack.signature)) {
+            for (auto pool : pools) {
+                pool->SwapIndices(pool->GetIndex(entityId), pack.size);
+            }
+            pack.size++;
+        }
+    }
+    componentPacks.push_back(pack);
+
+    Logger::Log("Component pack created with ", pack.size, " entities");
 }
 
 template <typename TComponent, typename ...TArgs>
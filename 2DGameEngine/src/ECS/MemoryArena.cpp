@@ -0,0 +1,91 @@
+#include "MemoryArena.h"
+#include <new>
+
+MemoryArena::MemoryArena() : allocatedBytes(0), reservedBytes(0) {
+}
+
+void* MemoryArena::Allocate(size_t bytes, size_t alignment) {
+    void* memory = ::operator new(bytes, std::align_val_t(alignment));
+    allocatedBytes += bytes;
+    reservedBytes += bytes;
+    return memory;
+}
+
+void MemoryArena::Deallocate(void* memory, size_t bytes, size_t alignment) {
+    ::operator delete(memory, std::align_val_t(alignment));
+    allocatedBytes -= bytes;
+    reservedBytes -= bytes;
+}
+
+size_t MemoryArena::GetAllocatedBytes() const {
+    return allocatedBytes;
+}
+
+size_t MemoryArena::GetReservedBytes() const {
+    return reservedBytes;
+}
+
+MemoryArena& MemoryArena::GetDefault() {
+    static MemoryArena defaultArena;
+    return defaultArena;
+}
+
+PageArena::~PageArena() {
+    Trim();
+}
+
+int PageArena::GetSizeClass(size_t bytes) {
+    int sizeClass = 0;
+    while ((PAGE_SIZE << sizeClass) < bytes) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+// Blocks are page aligned, which covers the alignment of every component type
+void* PageArena::Allocate(size_t bytes, size_t alignment) {
+    if (bytes < MIN_BLOCK_SIZE) {
+        return MemoryArena::Allocate(bytes, alignment);
+    }
+
+    const int sizeClass = GetSizeClass(bytes);
+    const size_t blockSize = PAGE_SIZE << sizeClass;
+    allocatedBytes += blockSize;
+
+    {
+        std::lock_guard<std::mutex> lock(freeBlocksMutex);
+        if (!freeBlocks[sizeClass].empty()) {
+            void* memory = freeBlocks[sizeClass].back();
+            freeBlocks[sizeClass].pop_back();
+            return memory;
+        }
+    }
+
+    reservedBytes += blockSize;
+    return ::operator new(blockSize, std::align_val_t(PAGE_SIZE));
+}
+
+void PageArena::Deallocate(void* memory, size_t bytes, size_t alignment) {
+    if (bytes < MIN_BLOCK_SIZE) {
+        MemoryArena::Deallocate(memory, bytes, alignment);
+        return;
+    }
+
+    const int sizeClass = GetSizeClass(bytes);
+    allocatedBytes -= PAGE_SIZE << sizeClass;
+
+    std::lock_guard<std::mutex> lock(freeBlocksMutex);
+    freeBlocks[sizeClass].push_back(memory);
+}
+
+void PageArena::Trim() {
+    std::lock_guard<std::mutex> lock(freeBlocksMutex);
+    for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; sizeClass++) {
+        for (void* memory : freeBlocks[sizeClass]) {
+            ::operator delete(memory, std::align_val_t(PAGE_SIZE));
+            reservedBytes -= PAGE_SIZE << sizeClass;
+        }
+        freeBlocks[sizeClass].clear();
+        freeBlocks[sizeClass].shrink_to_fit();
+    }
+}
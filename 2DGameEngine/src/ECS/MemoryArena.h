@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// MemoryArena
+////////////////////////////////////////////////////////////////////////////////
+// Source of the memory used by the component pools. The base arena forwards
+// to the global heap; other arenas can be plugged in by deriving from it and
+// handing them to the registry. Every arena counts the bytes it hands out, so
+// the pools memory use can be reported.
+////////////////////////////////////////////////////////////////////////////////
+class MemoryArena {
+protected:
+    std::atomic<size_t> allocatedBytes;
+    std::atomic<size_t> reservedBytes;
+
+public:
+    MemoryArena();
+    virtual ~MemoryArena() = default;
+
+    virtual void* Allocate(size_t bytes, size_t alignment);
+    virtual void Deallocate(void* memory, size_t bytes, size_t alignment);
+
+    // Gives the memory the arena keeps for later allocations back to the system
+    virtual void Trim() {}
+
+    // Bytes currently handed out, and bytes held by the arena (handed out or cached)
+    size_t GetAllocatedBytes() const;
+    size_t GetReservedBytes() const;
+
+    // Heap arena used by the registries that were not given one
+    static MemoryArena& GetDefault();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// PageArena
+////////////////////////////////////////////////////////////////////////////////
+// Rounds every allocation up to a power of two number of pages and keeps the
+// freed blocks in one free list per size, so pools that grow and shrink
+// between levels reuse the same blocks instead of going back to the heap.
+// Trim() releases the cached blocks. Small allocations go straight to the heap.
+////////////////////////////////////////////////////////////////////////////////
+class PageArena : public MemoryArena {
+private:
+    static const size_t PAGE_SIZE = 4096;
+    static const size_t MIN_BLOCK_SIZE = 256;
+    static const int NUM_SIZE_CLASSES = 32;
+
+    // [Vector index = size class, block size = PAGE_SIZE << size class]
+    std::vector<void*> freeBlocks[NUM_SIZE_CLASSES];
+    std::mutex freeBlocksMutex;
+
+    static int GetSizeClass(size_t bytes);
+
+public:
+    PageArena() = default;
+    ~PageArena() override;
+
+    void* Allocate(size_t bytes, size_t alignment) override;
+    void Deallocate(void* memory, size_t bytes, size_t alignment) override;
+    void Trim() override;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ArenaAllocator
+////////////////////////////////////////////////////////////////////////////////
+// Standard allocator that takes its memory from a MemoryArena, so the pool
+// vectors can be backed by any arena.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    MemoryArena* arena;
+
+    ArenaAllocator(MemoryArena& arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* memory, size_t n) {
+        arena->Deallocate(memory, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator ==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator !=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
@@ -0,0 +1,39 @@
+#include "Prefab.h"
+
+Prefab::Prefab(const std::string& name) : name(name) {
+}
+
+const std::string& Prefab::GetName() const {
+    return name;
+}
+
+const Signature& Prefab::GetSignature() const {
+    return signature;
+}
+
+Prefab& Prefab::Tag(const std::string& tag) {
+    tagId = Registry::GetTagId(tag);
+    return *this;
+}
+
+Prefab& Prefab::Group(const std::string& group) {
+    groupId = Registry::GetGroupId(group);
+    return *this;
+}
+
+Prefab& Prefab::SetRecycling(bool isRecycling) {
+    this->isRecycling = isRecycling;
+    return *this;
+}
+
+bool Prefab::IsRecycling() const {
+    return isRecycling;
+}
+
+void Prefab::Clear() {
+    components.clear();
+    signature.reset();
+    tagId = -1;
+    groupId = -1;
+    isRecycling = false;
+}
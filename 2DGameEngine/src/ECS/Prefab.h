@@ -0,0 +1,98 @@
+#pragma once
+#include "ECS.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+// Prefab
+////////////////////////////////////////////////////////////////////////////////
+// A prefab is a named set of component values, with an optional tag and
+// group, defined once (in C++ or in the level script) and owned by the
+// registry. Instantiating it copies every value straight into its pool and
+// gives the new entities the whole prefab signature in one step, instead of
+// adding the components one at a time. Prefabs of short-lived entities (e.g.
+// projectiles) can recycle their instances instead.
+////////////////////////////////////////////////////////////////////////////////
+class Prefab {
+private:
+    class IPrefabComponent {
+    public:
+        virtual ~IPrefabComponent() = default;
+
+        // Copies the component value to every entity of the array
+        virtual void CopyTo(Registry& registry, const Entity* entities, int count) const = 0;
+    };
+
+    template <typename TComponent>
+    class PrefabComponent : public IPrefabComponent {
+    public:
+        TComponent component;
+
+        template <typename ...TArgs>
+        PrefabComponent(TArgs&& ...args) : component(std::forward<TArgs>(args)...) {}
+
+        void CopyTo(Registry& registry, const Entity* entities, int count) const override {
+            registry.CopyComponent<TComponent>(component, entities, count);
+        }
+    };
+
+    std::string name;
+    Signature signature;
+
+    // [Vector index = component type id, nullptr = the prefab does not have the component]
+    std::vector<std::unique_ptr<IPrefabComponent>> components;
+
+    // -1 = no tag/group
+    int tagId = -1;
+    int groupId = -1;
+
+    bool isRecycling = false;
+
+    friend class Registry;
+
+public:
+    Prefab(const std::string& name);
+    Prefab(const Prefab&) = delete;
+    Prefab& operator =(const Prefab&) = delete;
+
+    const std::string& GetName() const;
+    const Signature& GetSignature() const;
+
+    // Sets the value of a component, replacing the previous value of the same type
+    template <typename TComponent, typename ...TArgs> Prefab& AddComponent(TArgs&& ...args);
+    template <typename TComponent> bool HasComponent() const;
+    template <typename TComponent> TComponent& GetComponent() const;
+
+    Prefab& Tag(const std::string& tag);
+    Prefab& Group(const std::string& group);
+
+    // Opt-in recycling: killed instances stay resident, out of the systems, with their components
+    // in the pools, and the next instantiations reactivate them instead of creating new entities
+    Prefab& SetRecycling(bool isRecycling);
+    bool IsRecycling() const;
+
+    // Removes every component, tag and group, and turns recycling off
+    void Clear();
+};
+
+template <typename TComponent, typename ...TArgs>
+Prefab& Prefab::AddComponent(TArgs&& ...args) {
+    const auto componentId = Component<TComponent>::GetId();
+    if (componentId >= static_cast<int>(components.size())) {
+        components.resize(componentId + 1);
+    }
+    components[componentId] = std::make_unique<PrefabComponent<TComponent>>(std::forward<TArgs>(args)...);
+    signature.set(componentId);
+    return *this;
+}
+
+template <typename TComponent>
+bool Prefab::HasComponent() const {
+    return signature.test(Component<TComponent>::GetId());
+}
+
+template <typename TComponent>
+TComponent& Prefab::GetComponent() const {
+    return static_cast<PrefabComponent<TComponent>*>(components[Component<TComponent>::GetId()].get())->component;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIGNATURE_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIGNATURE_USE_SSE2
+#endif
+
+// Number of component types a signature can hold (64, 128 or 256)
+#ifndef SIGNATURE_BITS
+#define SIGNATURE_BITS 64
+#endif
+
+static_assert(SIGNATURE_BITS == 64 || SIGNATURE_BITS == 128 || SIGNATURE_BITS == 256, "SIGNATURE_BITS must be 64, 128 or 256");
+
+////////////////////////////////////////////////////////////////////////////////
+// Signature
+////////////////////////////////////////////////////////////////////////////////
+// We use a fixed set of bits (1s and 0s) to keep track of which components an
+// entity has, and also helps keep track of which entities a system is
+// interested in. The bits are stored in 64-bit words that are matched
+// without branches. Only 256-bit signatures use SSE2 (or AVX2): at 64 and
+// 128 bits a match costs about as much as with std::bitset, at 256 bits it
+// stays near the 128-bit cost where std::bitset is several times slower (see
+// the signature benchmark of the Benchmarks project).
+////////////////////////////////////////////////////////////////////////////////
+class alignas(SIGNATURE_BITS >= 256 ? 32 : SIGNATURE_BITS >= 128 ? 16 : 8) Signature {
+public:
+    static constexpr size_t NUM_BITS = SIGNATURE_BITS;
+    static constexpr size_t NUM_WORDS = SIGNATURE_BITS / 64;
+
+private:
+    uint64_t words[NUM_WORDS] = {};
+
+public:
+    bool test(size_t bit) const {
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    Signature& set(size_t bit, bool value = true) {
+        const uint64_t mask = uint64_t(1) << (bit % 64);
+        words[bit / 64] = value ? (words[bit / 64] | mask) : (words[bit / 64] & ~mask);
+        return *this;
+    }
+
+    Signature& reset() {
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            words[i] = 0;
+        }
+        return *this;
+    }
+
+    bool any() const {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            bits |= words[i];
+        }
+        return bits != 0;
+    }
+
+    bool none() const {
+        return !any();
+    }
+
+    // True if every bit set in other is also set in this signature, i.e. (*this & other) == other
+    bool Contains(const Signature& other) const {
+#if defined(SIGNATURE_USE_AVX2)
+        if constexpr (NUM_WORDS == 4) {
+            const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(words));
+            const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(other.words));
+            return _mm256_testc_si256(a, b) != 0;
+        }
+#endif
+#if defined(SIGNATURE_USE_AVX2) || defined(SIGNATURE_USE_SSE2)
+        // One or two words are cheaper to match with plain integer operations
+        if constexpr (NUM_WORDS >= 4) {
+            __m128i missing = _mm_setzero_si128();
+            for (size_t i = 0; i < NUM_WORDS; i += 2) {
+                const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(words + i));
+                const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(other.words + i));
+                missing = _mm_or_si128(missing, _mm_andnot_si128(a, b));
+            }
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+        }
+#endif
+        uint64_t missing = 0;
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            missing |= other.words[i] & ~words[i];
+        }
+        return missing == 0;
+    }
+
+    // True if the two signatures have at least one bit in common
+    bool Intersects(const Signature& other) const {
+        uint64_t common = 0;
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            common |= words[i] & other.words[i];
+        }
+        return common != 0;
+    }
+
+    Signature& operator &=(const Signature& other) {
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+
+    Signature& operator |=(const Signature& other) {
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+
+    Signature& operator ^=(const Signature& other) {
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            words[i] ^= other.words[i];
+        }
+        return *this;
+    }
+
+    Signature operator &(const Signature& other) const { return Signature(*this) &= other; }
+    Signature operator |(const Signature& other) const { return Signature(*this) |= other; }
+    Signature operator ^(const Signature& other) const { return Signature(*this) ^= other; }
+
+    bool operator ==(const Signature& other) const {
+        uint64_t difference = 0;
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            difference |= words[i] ^ other.words[i];
+        }
+        return difference == 0;
+    }
+
+    bool operator !=(const Signature& other) const {
+        return !(*this == other);
+    }
+};
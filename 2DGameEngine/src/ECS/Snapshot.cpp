@@ -0,0 +1,92 @@
+#include "Snapshot.h"
+#include "../Logger/Logger.h"
+#include <fstream>
+
+void SnapshotWriter::Reserve(size_t size) {
+    buffer.reserve(size);
+}
+
+void SnapshotWriter::WriteBytes(const void* bytes, size_t size) {
+    const char* first = static_cast<const char*>(bytes);
+    buffer.insert(buffer.end(), first, first + size);
+}
+
+void SnapshotWriter::WriteString(const std::string& value) {
+    Write(static_cast<uint32_t>(value.size()));
+    WriteBytes(value.data(), value.size());
+}
+
+const std::vector<char>& SnapshotWriter::GetBuffer() const {
+    return buffer;
+}
+
+bool SnapshotWriter::SaveToFile(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Logger::Err("Cannot open snapshot file ", filePath, " for writing");
+        return false;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        Logger::Err("Cannot write snapshot file ", filePath);
+        return false;
+    }
+    return true;
+}
+
+SnapshotReader::SnapshotReader(std::vector<char> buffer) : buffer(std::move(buffer)) {
+    data = this->buffer.data();
+    size = this->buffer.size();
+}
+
+SnapshotReader::SnapshotReader(const char* data, size_t size) : data(data), size(size) {
+}
+
+bool SnapshotReader::LoadFromFile(const std::string& filePath) {
+    buffer.clear();
+    isValid = file.Open(filePath);
+    data = file.GetData();
+    size = file.GetSize();
+    position = 0;
+    return isValid;
+}
+
+bool SnapshotReader::ReadBytes(void* bytes, size_t size) {
+    if (!isValid || size > this->size - position) {
+        isValid = false;
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(bytes, data + position, size);
+    }
+    position += size;
+    return true;
+}
+
+bool SnapshotReader::ReadString(std::string& value) {
+    std::string_view view;
+    if (!ReadStringView(view)) {
+        return false;
+    }
+    value.assign(view.data(), view.size());
+    return true;
+}
+
+bool SnapshotReader::ReadStringView(std::string_view& value) {
+    uint32_t length;
+    if (!Read(length) || length > size - position) {
+        isValid = false;
+        return false;
+    }
+    value = std::string_view(data + position, length);
+    position += length;
+    return true;
+}
+
+size_t SnapshotReader::GetRemainingSize() const {
+    return size - position;
+}
+
+bool SnapshotReader::IsValid() const {
+    return isValid;
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "../FileSystem/MappedFile.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// Snapshot files start with this magic number, and the version of the format is bumped
+// every time the layout changes (older snapshots are rejected)
+const uint32_t SNAPSHOT_MAGIC = 0x53534345; // "ECSS"
+const uint32_t SNAPSHOT_VERSION = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+// SnapshotWriter
+////////////////////////////////////////////////////////////////////////////////
+// Appends raw values and arrays to a byte buffer. Snapshots are meant to be
+// loaded by the same build on the same platform, so values are written with
+// their in-memory layout.
+////////////////////////////////////////////////////////////////////////////////
+class SnapshotWriter {
+private:
+    std::vector<char> buffer;
+
+public:
+    // Grows the buffer once, when the size of the snapshot is known up front
+    void Reserve(size_t size);
+
+    void WriteBytes(const void* bytes, size_t size);
+    void WriteString(const std::string& value);
+
+    template <typename T>
+    void Write(const T& value) {
+        WriteArray(&value, 1);
+    }
+
+    template <typename T>
+    void WriteArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written as raw bytes");
+        WriteBytes(values, count * sizeof(T));
+    }
+
+    const std::vector<char>& GetBuffer() const;
+    bool SaveToFile(const std::string& filePath) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SnapshotReader
+////////////////////////////////////////////////////////////////////////////////
+// Reads back what a SnapshotWriter wrote, from a buffer or from a memory
+// mapped file, so the pools copy their arrays straight from the file pages.
+// Reading past the end of the data fails and invalidates the reader, so
+// truncated files are detected.
+////////////////////////////////////////////////////////////////////////////////
+class SnapshotReader {
+private:
+    std::vector<char> buffer;
+    MappedFile file;
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+    bool isValid = true;
+
+public:
+    SnapshotReader() = default;
+    explicit SnapshotReader(std::vector<char> buffer);
+
+    // Reads memory owned by the caller, which must outlive the reader
+    SnapshotReader(const char* data, size_t size);
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator =(const SnapshotReader&) = delete;
+
+    bool LoadFromFile(const std::string& filePath);
+
+    bool ReadBytes(void* bytes, size_t size);
+    bool ReadString(std::string& value);
+
+    // The view points into the reader data, and is only valid as long as the reader
+    bool ReadStringView(std::string_view& value);
+
+    template <typename T>
+    bool Read(T& value) {
+        return ReadArray(&value, 1);
+    }
+
+    template <typename T>
+    bool ReadArray(T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read as raw bytes");
+        return ReadBytes(values, count * sizeof(T));
+    }
+
+    size_t GetRemainingSize() const;
+    bool IsValid() const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ComponentSerializer
+////////////////////////////////////////////////////////////////////////////////
+// Writes and reads a packed array of components of type T. By default the
+// components that are trivially copyable are written as a single block of
+// raw bytes, and the other ones are left out of snapshots. Components that
+// hold strings, asset handles or timestamps specialize it next to their
+// declaration, so every pool of that type sees the specialization.
+// MIN_BYTES is the smallest size of a component in a snapshot, which bounds
+// the number of components a snapshot of a given size can hold.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+struct ComponentSerializer {
+    static const bool IS_SERIALIZABLE = std::is_trivially_copyable<T>::value;
+    static const size_t MIN_BYTES = sizeof(T);
+
+    static void Write(SnapshotWriter& writer, const T* components, int count) {
+        writer.WriteArray(components, count);
+    }
+
+    static bool Read(SnapshotReader& reader, T* components, int count) {
+        return reader.ReadArray(components, count);
+    }
+};
+
+// Components are read as raw bytes, so a corrupt snapshot can load a bool that is neither 0 nor 1, and
+// reading such a bool is undefined behavior. The specializations call this on their bool members
+// after the raw read, which goes through the byte and stores a valid bool.
+template <typename TObject>
+void NormalizeBools(TObject* objects, int count, bool TObject::* member) {
+    for (int i = 0; i < count; i++) {
+        unsigned char byte;
+        std::memcpy(&byte, &(objects[i].*member), sizeof(byte));
+        objects[i].*member = byte != 0;
+    }
+}
+
+// Likewise for enums, whose raw values are checked against the range of the enum. Returns false if
+// one of them is out of range.
+template <typename TObject, typename TEnum>
+bool AreEnumsInRange(const TObject* objects, int count, TEnum TObject::* member, std::underlying_type_t<TEnum> minValue, std::underlying_type_t<TEnum> maxValue) {
+    for (int i = 0; i < count; i++) {
+        std::underlying_type_t<TEnum> value;
+        std::memcpy(&value, &(objects[i].*member), sizeof(value));
+        if (value < minValue || value > maxValue) {
+            return false;
+        }
+    }
+    return true;
+}
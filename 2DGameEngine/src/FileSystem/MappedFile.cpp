@@ -0,0 +1,196 @@
+#include "MappedFile.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator =(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#else
+        std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        Logger::Err("Cannot open file ", filePath);
+        return false;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        Logger::Err("Cannot read the size of file ", filePath);
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files cannot be mapped, they are open without data
+    if (size == 0) {
+        return true;
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        Logger::Err("Cannot map file ", filePath);
+        Close();
+        return false;
+    }
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor == -1) {
+        Logger::Err("Cannot open file ", filePath);
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == -1) {
+        Logger::Err("Cannot read the size of file ", filePath);
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileStatus.st_size);
+
+    // Empty files cannot be mapped, they are open without data
+    if (size == 0) {
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    data = mapping != MAP_FAILED ? static_cast<const char*>(mapping) : nullptr;
+#endif
+
+    if (!data) {
+        Logger::Err("Cannot map file ", filePath);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+    if (fileDescriptor != -1) {
+        close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// Both hints work on whole pages, the range is shrunk to the pages it fully covers
+static bool GetPageRange(const char* data, size_t dataSize, size_t offset, size_t size, char*& first, size_t& length) {
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const uintptr_t pageSize = systemInfo.dwPageSize;
+#else
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+#endif
+    if (!data || offset >= dataSize) {
+        return false;
+    }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data + offset);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(data + offset + std::min(size, dataSize - offset));
+    const uintptr_t pageBegin = (begin + pageSize - 1) & ~(pageSize - 1);
+    const uintptr_t pageEnd = end & ~(pageSize - 1);
+    if (pageBegin >= pageEnd) {
+        return false;
+    }
+    first = reinterpret_cast<char*>(pageBegin);
+    length = pageEnd - pageBegin;
+    return true;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const {
+    char* first;
+    size_t length;
+    if (!GetPageRange(data, this->size, offset, size, first, length)) {
+        return;
+    }
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = { first, length };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(first, length, MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::Release(size_t offset, size_t size) const {
+    char* first;
+    size_t length;
+    if (!GetPageRange(data, this->size, offset, size, first, length)) {
+        return;
+    }
+#ifdef _WIN32
+    // Unlocking pages that are not locked removes them from the working set of the process
+    VirtualUnlock(first, length);
+#else
+    madvise(first, length, MADV_DONTNEED);
+#endif
+}
+
+bool MappedFile::IsOpen() const {
+#ifdef _WIN32
+    return fileHandle != nullptr;
+#else
+    return fileDescriptor != -1;
+#endif
+}
+
+const char* MappedFile::GetData() const {
+    return data;
+}
+
+size_t MappedFile::GetSize() const {
+    return size;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+// MappedFile
+////////////////////////////////////////////////////////////////////////////////
+// Read-only memory mapping of a whole file. The pages are loaded by the OS
+// when they are first touched, so opening a big file is instant and only the
+// parts that are read take memory. The mapping is released when the object
+// is destroyed (or when another file is opened).
+////////////////////////////////////////////////////////////////////////////////
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator =(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator =(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    // Hints for the OS: load the pages of a range ahead of their use, or drop them from the memory
+    // of the process (they are read again from the file if they are touched later)
+    void Prefetch(size_t offset, size_t size) const;
+    void Release(size_t offset, size_t size) const;
+
+    bool IsOpen() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+};
@@ -6,6 +6,8 @@
 #include "./LevelLoader.h"
 #include "../Logger/Logger.h"
 #include "../ECS/ECS.h"
+#include "../ECS/Prefab.h"
+#include "../Tilemap/TileLayer.h"
 #include "../Systems/MovementSystem.h"
 #include "../Systems/RenderSystem.h"
 #include "../Systems/AnimationSystem.h"
@@ -31,12 +33,20 @@ int Game::mapWidth;
 int Game::mapHeight;
 const int Game::DEFAULT_CHANNEL;
 
+// Snapshot of the registry saved with F5 and loaded with F9. The snapshot does not hold the assets,
+// so it is only meant to be loaded while the level it was saved in is loaded.
+static const char* QUICKSAVE_FILE_PATH = "./quicksave.snapshot";
+
 Game::Game() {
     isRunning = false;
     isDebug = false;
-    registry = std::make_unique<Registry>();
+    poolArena = std::make_unique<PageArena>();
+    registry = std::make_unique<Registry>(*poolArena);
+    tileLayer = std::make_unique<TileLayer>();
     assetStore = std::make_unique<AssetStore>();
     eventBus = std::make_unique<EventBus>();
+    threadPool = std::make_unique<ThreadPool>(ThreadPool::GetDefaultNumThreads());
+    scheduler = std::make_unique<Scheduler>(*threadPool);
     Logger::Log("Game constructor called!");
 }
 
@@ -116,13 +126,45 @@ void Game::ProcessInput() {
             if (sdlEvent.key.keysym.sym == SDLK_F1) {
                 isDebug = !isDebug;
             }
+            if (sdlEvent.key.keysym.sym == SDLK_F5) {
+                registry->SaveSnapshot(QUICKSAVE_FILE_PATH);
+            }
+            if (sdlEvent.key.keysym.sym == SDLK_F9) {
+                registry->LoadSnapshot(QUICKSAVE_FILE_PATH);
+            }
             eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
             break;
         }
     }
 }
 
+// Everything a projectile needs, the emitter then sets its position, velocity and damage. Projectiles
+// are recycled, so the steady stream of spawns and kills does not go through the pools. A level can
+// redefine the "projectile" prefab, e.g. to change the bullet sprite.
+Prefab& Game::CreateProjectilePrefab() {
+    Prefab& projectilePrefab = registry->CreatePrefab("projectile");
+    projectilePrefab.Group("projectiles");
+    projectilePrefab.SetRecycling(true);
+    projectilePrefab.AddComponent<TransformComponent>(glm::vec2(0.0, 0.0), glm::vec2(1.0, 1.0), 0.0);
+    projectilePrefab.AddComponent<RigidBodyComponent>();
+    projectilePrefab.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
+    projectilePrefab.AddComponent<BoxColliderComponent>(4, 4, glm::vec2(0), COLLISION_LAYER_PROJECTILES, COLLISION_LAYER_PLAYER | COLLISION_LAYER_ENEMIES);
+    projectilePrefab.AddComponent<ProjectileComponent>();
+    return projectilePrefab;
+}
+
+void Game::RegisterComponents(Registry& registry) {
+    registry.RegisterComponents<
+        TransformComponent, RigidBodyComponent, SpriteComponent, AnimationComponent, BoxColliderComponent,
+        KeyboardControlledComponent, CameraFollowComponent, ProjectileEmitterComponent, ProjectileComponent,
+        HealthComponent, TextLabelComponent, ScriptComponent, AudioComponent
+    >();
+}
+
 void Game::Setup() {
+    // Create every component pool, so a snapshot can be loaded before the level adds any component
+    RegisterComponents(*registry);
+
     // Add the sytems that need to be processed in our game
     registry->AddSystem<MovementSystem>();
     registry->AddSystem<RenderSystem>();
@@ -132,7 +174,7 @@ void Game::Setup() {
     registry->AddSystem<DamageSystem>();
     registry->AddSystem<KeyboardControlSystem>();
     registry->AddSystem<CameraMovementSystem>();
-    registry->AddSystem<ProjectileEmitSystem>();
+    registry->AddSystem<ProjectileEmitSystem>(registry->CreateCommandBuffer(), CreateProjectilePrefab());
     registry->AddSystem<ProjectileLifecycleSystem>();
     registry->AddSystem<RenderTextSystem>();
     registry->AddSystem<RenderHealthBarSystem>();
@@ -140,13 +182,16 @@ void Game::Setup() {
     registry->AddSystem<ScriptSystem>();
     registry->AddSystem<PlayAudioSystem>();
 
+    // Keep the moving entities packed so the MovementSystem iterates contiguous arrays
+    registry->AddPack<TransformComponent, RigidBodyComponent>();
+
     // Create the bidings between C++ and Lua
-    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua);
+    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua, *registry);
 
     // Load the first level
     LevelLoader loader;
     lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
-    loader.LoadLevel(lua, registry, assetStore, renderer, 1);
+    loader.LoadLevel(lua, registry, *tileLayer, assetStore, renderer, 1);
 }
 
 void Game::Update() {
@@ -174,25 +219,43 @@ void Game::Update() {
     // Update the registry to process the entities that are waiting to be created/deleted
     registry->Update();
 
-    // Invoke all the systems that need to update 
-    registry->GetSystem<MovementSystem>().Update(deltaTime);
-    registry->GetSystem<AnimationSystem>().Update();
-    registry->GetSystem<CollisionSystem>().Update(eventBus);
-    registry->GetSystem<ProjectileEmitSystem>().Update(registry);
-    registry->GetSystem<CameraMovementSystem>().Update(camera);
-    registry->GetSystem<ProjectileLifecycleSystem>().Update();
-    registry->GetSystem<ScriptSystem>().Update(deltaTime, SDL_GetTicks());
-    registry->GetSystem<PlayAudioSystem>().Update(assetStore);
+    // Invoke all the systems that need to update, letting the scheduler run the ones
+    // that do not access the same components concurrently
+    auto& movementSystem = registry->GetSystem<MovementSystem>();
+    auto& animationSystem = registry->GetSystem<AnimationSystem>();
+    auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+    auto& projectileEmitSystem = registry->GetSystem<ProjectileEmitSystem>();
+    auto& cameraMovementSystem = registry->GetSystem<CameraMovementSystem>();
+    auto& projectileLifecycleSystem = registry->GetSystem<ProjectileLifecycleSystem>();
+    auto& scriptSystem = registry->GetSystem<ScriptSystem>();
+    auto& playAudioSystem = registry->GetSystem<PlayAudioSystem>();
+    const int ellapsedTime = SDL_GetTicks();
+
+    scheduler->AddJob(movementSystem, [&]() { movementSystem.Update(registry, *threadPool, deltaTime); });
+    scheduler->AddJob(animationSystem, [&]() { animationSystem.Update(registry, *threadPool); });
+    scheduler->AddJob(collisionSystem, [&]() { collisionSystem.Update(eventBus); });
+    scheduler->AddJob(projectileEmitSystem, [&]() { projectileEmitSystem.Update(); });
+    scheduler->AddJob(cameraMovementSystem, [&]() { cameraMovementSystem.Update(camera); });
+    scheduler->AddJob(projectileLifecycleSystem, [&]() { projectileLifecycleSystem.Update(); });
+    scheduler->AddJob(scriptSystem, [&]() { scriptSystem.Update(deltaTime, ellapsedTime); });
+    scheduler->AddJob(playAudioSystem, [&]() { playAudioSystem.Update(assetStore); });
+    scheduler->Run();
+
+    // Page the map chunks in and out around the camera, now that it has moved
+    tileLayer->UpdateResidency(camera);
 }
 
 void Game::Render() {
     SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
     SDL_RenderClear(renderer);
 
+    // The map is drawn under all the sprites
+    tileLayer->Render(renderer, assetStore, camera);
+
     // Invoke all the systems that need to render 
-    registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera);
+    registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera, *threadPool);
     registry->GetSystem<RenderTextSystem>().Update(renderer, assetStore, camera);
-    registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetStore, camera);
+    registry->GetSystem<RenderHealthBarSystem>().Update(registry, renderer, assetStore, camera);
     if (isDebug) {
         registry->GetSystem<RenderColliderSystem>().Update(renderer, camera);
         registry->GetSystem<RenderGUISystem>().Update(registry, camera);
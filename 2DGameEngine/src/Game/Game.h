@@ -4,6 +4,9 @@
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h"
+#include "../Scheduler/ThreadPool.h"
+#include "../Scheduler/Scheduler.h"
+#include "../Tilemap/TileLayer.h"
 
 const int FPS = 60;
 const int MILLISECS_PER_FRAME = 1000 / FPS;
@@ -18,9 +21,17 @@ private:
 	SDL_Rect camera;
 
 	sol::state lua;
+
+	// Declared before the registry, so the pools are destroyed before their memory arena
+	std::unique_ptr<PageArena> poolArena;
 	std::unique_ptr<Registry> registry;
+	std::unique_ptr<TileLayer> tileLayer;
 	std::unique_ptr<AssetStore> assetStore;
 	std::unique_ptr<EventBus> eventBus;
+	std::unique_ptr<ThreadPool> threadPool;
+	std::unique_ptr<Scheduler> scheduler;
+
+	Prefab& CreateProjectilePrefab();
 
 public:
 	static int windowWidth;
@@ -29,6 +40,9 @@ public:
 	static int mapHeight;
 	const static int DEFAULT_CHANNEL = -100;
 
+	// Creates the pool of every component type of the game (see Registry::RegisterComponents())
+	static void RegisterComponents(Registry& registry);
+
 	Game();
 	~Game();
 	void Initialize();
@@ -1,8 +1,14 @@
 #include <fstream>
 #include <string>
+#include <vector>
+#include <unordered_set>
+#include <filesystem>
 #include <sol/sol.hpp>
 #include "./Game.h"
 #include "./LevelLoader.h"
+#include "../ECS/Prefab.h"
+#include "../ECS/Snapshot.h"
+#include "../Tilemap/TileLayer.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
@@ -11,6 +17,7 @@
 #include "../Components/KeyboardControlledComponent.h"
 #include "../Components/CameraFollowComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
+#include "../Components/ProjectileComponent.h"
 #include "../Components/TextLabelComponent.h"
 #include "../Components/HealthComponent.h"
 #include "../Components/ScriptComponent.h"
@@ -24,25 +31,275 @@ LevelLoader::~LevelLoader() {
     Logger::Log("LevelLoader destructor called!");
 }
 
-void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber) {
+// Grows each component pool once to the capacity the level asks for, keyed by the component names used in the level entities
+static void ReservePools(Registry& registry, const sol::table& poolCapacity) {
+    for (auto& capacity : poolCapacity) {
+        const std::string componentName = capacity.first.as<std::string>();
+        const int count = capacity.second.as<int>();
+        if (componentName == "transform") {
+            registry.ReserveComponents<TransformComponent>(count);
+        }
+        else if (componentName == "rigidbody") {
+            registry.ReserveComponents<RigidBodyComponent>(count);
+        }
+        else if (componentName == "sprite") {
+            registry.ReserveComponents<SpriteComponent>(count);
+        }
+        else if (componentName == "animation") {
+            registry.ReserveComponents<AnimationComponent>(count);
+        }
+        else if (componentName == "boxcollider") {
+            registry.ReserveComponents<BoxColliderComponent>(count);
+        }
+        else if (componentName == "keyboard_controller") {
+            registry.ReserveComponents<KeyboardControlledComponent>(count);
+        }
+        else if (componentName == "camera_follow") {
+            registry.ReserveComponents<CameraFollowComponent>(count);
+        }
+        else if (componentName == "projectile_emitter") {
+            registry.ReserveComponents<ProjectileEmitterComponent>(count);
+        }
+        else if (componentName == "projectile") {
+            registry.ReserveComponents<ProjectileComponent>(count);
+        }
+        else if (componentName == "health") {
+            registry.ReserveComponents<HealthComponent>(count);
+        }
+        else if (componentName == "text_label") {
+            registry.ReserveComponents<TextLabelComponent>(count);
+        }
+        else if (componentName == "on_update_script") {
+            registry.ReserveComponents<ScriptComponent>(count);
+        }
+        else if (componentName == "audio") {
+            registry.ReserveComponents<AudioComponent>(count);
+        }
+        else {
+            Logger::Warn("Unknown component in the level pool capacity: ", componentName);
+        }
+    }
+}
+
+// Bit of a collision layer named in a level table, the unknown names have no bit
+static uint32_t GetCollisionLayer(const std::string& layerName) {
+    if (layerName == "default") {
+        return COLLISION_LAYER_DEFAULT;
+    }
+    if (layerName == "player") {
+        return COLLISION_LAYER_PLAYER;
+    }
+    if (layerName == "enemies") {
+        return COLLISION_LAYER_ENEMIES;
+    }
+    if (layerName == "projectiles") {
+        return COLLISION_LAYER_PROJECTILES;
+    }
+    if (layerName == "obstacles") {
+        return COLLISION_LAYER_OBSTACLES;
+    }
+    Logger::Warn("Unknown collision layer in the level: ", layerName);
+    return COLLISION_LAYER_NONE;
+}
+
+// Adds the components described in a level table to an entity, or to a prefab
+template <typename TTarget>
+static void LoadComponents(const sol::table& components, TTarget& target) {
+    // Transform
+    sol::optional<sol::table> transform = components["transform"];
+    if (transform != sol::nullopt) {
+        target.template AddComponent<TransformComponent>(
+            glm::vec2(
+                components["transform"]["position"]["x"],
+                components["transform"]["position"]["y"]
+            ),
+            glm::vec2(
+                components["transform"]["scale"]["x"].get_or(1.0),
+                components["transform"]["scale"]["y"].get_or(1.0)
+            ),
+            components["transform"]["rotation"].get_or(0.0)
+        );
+    }
+
+    // RigidBody
+    sol::optional<sol::table> rigidbody = components["rigidbody"];
+    if (rigidbody != sol::nullopt) {
+        target.template AddComponent<RigidBodyComponent>(
+            glm::vec2(
+                components["rigidbody"]["velocity"]["x"].get_or(0.0),
+                components["rigidbody"]["velocity"]["y"].get_or(0.0)
+            )
+        );
+    }
+
+    // Audio
+    sol::optional<sol::table> audio = components["audio"];
+    if (audio != sol::nullopt) {
+        Logger::Log("Audio component found.");
+        std::string audioAssetId = audio.value().get_or<std::string>("audio_asset_id", "");
+        if (!audioAssetId.empty()) {
+            Logger::Log("Audio Asset ID: " + audioAssetId);
+            target.template AddComponent<AudioComponent>(audioAssetId, components["audio"]["channel"]);
+        }
+        else {
+            Logger::Log("audio_asset_id is empty.");
+        }
+    }
+    else {
+        Logger::Log("Audio component not found for this entity.");
+    }
+
+    // Sprite
+    sol::optional<sol::table> sprite = components["sprite"];
+    if (sprite != sol::nullopt) {
+        target.template AddComponent<SpriteComponent>(
+            components["sprite"]["texture_asset_id"].get<std::string>(),
+            components["sprite"]["width"],
+            components["sprite"]["height"],
+            components["sprite"]["z_index"].get_or(1),
+            components["sprite"]["fixed"].get_or(false),
+            components["sprite"]["src_rect_x"].get_or(0),
+            components["sprite"]["src_rect_y"].get_or(0)
+        );
+    }
+
+    // Animation
+    sol::optional<sol::table> animation = components["animation"];
+    if (animation != sol::nullopt) {
+        target.template AddComponent<AnimationComponent>(
+            components["animation"]["num_frames"].get_or(1),
+            components["animation"]["speed_rate"].get_or(1)
+        );
+    }
+
+    // BoxCollider
+    sol::optional<sol::table> collider = components["boxcollider"];
+    if (collider != sol::nullopt) {
+        // The layer is a name, and collides_with a list of names; by default a collider collides with all the layers
+        uint32_t layer = COLLISION_LAYER_DEFAULT;
+        sol::optional<std::string> layerName = components["boxcollider"]["layer"];
+        if (layerName != sol::nullopt) {
+            layer = GetCollisionLayer(layerName.value());
+        }
+        uint32_t collidesWith = COLLISION_LAYER_ALL;
+        sol::optional<sol::table> collidesWithNames = components["boxcollider"]["collides_with"];
+        if (collidesWithNames != sol::nullopt) {
+            collidesWith = COLLISION_LAYER_NONE;
+            for (auto& collidesWithName : collidesWithNames.value()) {
+                collidesWith |= GetCollisionLayer(collidesWithName.second.as<std::string>());
+            }
+        }
+
+        target.template AddComponent<BoxColliderComponent>(
+            components["boxcollider"]["width"],
+            components["boxcollider"]["height"],
+            glm::vec2(
+                components["boxcollider"]["offset"]["x"].get_or(0),
+                components["boxcollider"]["offset"]["y"].get_or(0)
+            ),
+            layer,
+            collidesWith
+        );
+    }
+
+    // Health
+    sol::optional<sol::table> health = components["health"];
+    if (health != sol::nullopt) {
+        target.template AddComponent<HealthComponent>(
+            static_cast<int>(components["health"]["health_percentage"].get_or(100))
+        );
+    }
+
+    // ProjectileEmitter
+    sol::optional<sol::table> projectileEmitter = components["projectile_emitter"];
+    if (projectileEmitter != sol::nullopt) {
+        target.template AddComponent<ProjectileEmitterComponent>(
+            glm::vec2(
+                components["projectile_emitter"]["projectile_velocity"]["x"],
+                components["projectile_emitter"]["projectile_velocity"]["y"]
+            ),
+            static_cast<int>(components["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
+            static_cast<int>(components["projectile_emitter"]["projectile_duration"].get_or(10)) * 1000,
+            static_cast<int>(components["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
+            components["projectile_emitter"]["friendly"].get_or(false)
+        );
+    }
+
+    // CameraFollow
+    sol::optional<sol::table> cameraFollow = components["camera_follow"];
+    if (cameraFollow != sol::nullopt) {
+        target.template AddComponent<CameraFollowComponent>();
+    }
+
+    // KeyboardControlled
+    sol::optional<sol::table> keyboardControlled = components["keyboard_controller"];
+    if (keyboardControlled != sol::nullopt) {
+        target.template AddComponent<KeyboardControlledComponent>(
+            glm::vec2(
+                components["keyboard_controller"]["up_velocity"]["x"],
+                components["keyboard_controller"]["up_velocity"]["y"]
+            ),
+            glm::vec2(
+                components["keyboard_controller"]["right_velocity"]["x"],
+                components["keyboard_controller"]["right_velocity"]["y"]
+            ),
+            glm::vec2(
+                components["keyboard_controller"]["down_velocity"]["x"],
+                components["keyboard_controller"]["down_velocity"]["y"]
+            ),
+            glm::vec2(
+                components["keyboard_controller"]["left_velocity"]["x"],
+                components["keyboard_controller"]["left_velocity"]["y"]
+            )
+        );
+    }
+
+    // Script
+    sol::optional<sol::table> script = components["on_update_script"];
+    if (script != sol::nullopt) {
+        sol::function func = components["on_update_script"][0];
+        target.template AddComponent<ScriptComponent>(func);
+    }
+}
+
+// Compiled levels start with this magic number, and the version is bumped every time the layout changes
+static const uint32_t COMPILED_LEVEL_MAGIC = 0x4C564C32; // "2LVL"
+static const uint32_t COMPILED_LEVEL_VERSION = 4;
+
+// Types of the level globals saved in a compiled level
+enum CompiledGlobalType {
+    GLOBAL_NUMBER,
+    GLOBAL_STRING,
+    GLOBAL_BOOLEAN
+};
+
+struct LevelAsset {
+    std::string type;
+    std::string id;
+    std::string file;
+    int fontSize;
+};
+
+// Executes the level script, which defines the global Level table
+static sol::optional<sol::table> RunLevelScript(sol::state& lua, const std::string& scriptPath) {
     // This checks the syntax of our script, but it does not execute the script
-    sol::load_result script = lua.load_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
+    sol::load_result script = lua.load_file(scriptPath);
     if (!script.valid()) {
         sol::error err = script;
         std::string errorMessage = err.what();
         Logger::Err("Error loading the lua script: " + errorMessage);
-        return;
+        return sol::nullopt;
     }
 
     // Executes the script using the Sol state
-    lua.script_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
+    lua.script_file(scriptPath);
 
     // Read the big table for the current level
-    sol::table level = lua["Level"];
+    return lua["Level"].get<sol::optional<sol::table>>();
+}
 
-    ////////////////////////////////////////////////////////////////////////////
-    // Read the level assets
-    ////////////////////////////////////////////////////////////////////////////
+static std::vector<LevelAsset> ReadAssets(const sol::table& level) {
+    std::vector<LevelAsset> levelAssets;
     sol::table assets = level["assets"];
 
     int i = 0;
@@ -52,67 +309,115 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
             break;
         }
         sol::table asset = assets[i];
-        std::string assetType = asset["type"];
-        std::string assetId = asset["id"];
-        if (assetType == "texture") {
-            assetStore->AddTexture(renderer, assetId, asset["file"]);
-            Logger::Log("A new texture asset was added to the asset store, id: " + assetId);
+        LevelAsset levelAsset;
+        levelAsset.type = asset["type"];
+        levelAsset.id = asset["id"];
+        levelAsset.file = asset["file"];
+        levelAsset.fontSize = asset["font_size"].get_or(0);
+        levelAssets.push_back(levelAsset);
+        i++;
+    }
+    return levelAssets;
+}
+
+static void LoadAssets(const std::vector<LevelAsset>& levelAssets, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer) {
+    for (auto& asset : levelAssets) {
+        if (asset.type == "texture") {
+            assetStore->AddTexture(renderer, asset.id, asset.file);
+            Logger::Log("A new texture asset was added to the asset store, id: " + asset.id);
         }
-        if (assetType == "font") {
-            assetStore->AddFont(assetId, asset["file"], asset["font_size"]);
-            Logger::Log("A new font asset was added to the asset store, id: " + assetId);
+        if (asset.type == "font") {
+            assetStore->AddFont(asset.id, asset.file, asset.fontSize);
+            Logger::Log("A new font asset was added to the asset store, id: " + asset.id);
         }
-        if (assetType == "audio") {
-            assetStore->AddAudio(assetId, asset["file"]);
-            Logger::Log("A new audio asset was added to the asset store, id: " + assetId);
+        if (asset.type == "audio") {
+            assetStore->AddAudio(asset.id, asset.file);
+            Logger::Log("A new audio asset was added to the asset store, id: " + asset.id);
         }
-        i++;
     }
+}
 
-    ////////////////////////////////////////////////////////////////////////////
-    // Read the level tilemap information
-    ////////////////////////////////////////////////////////////////////////////
+// Fills the tile layer with the level map, and returns the paths of the map files it was read from.
+// A binary tilemap converted from the map file (see TileLayer::ConvertMapFile()) is streamed instead
+// of the text map when it is up to date.
+static std::vector<std::string> LoadTilemap(const sol::table& level, TileLayer& tileLayer) {
     sol::table map = level["tilemap"];
     std::string mapFilePath = map["map_file"];
-    std::string mapTextureAssetId = map["texture_asset_id"];
+    TextureHandle mapTexture = map["texture_asset_id"].get<std::string>();
     int mapNumRows = map["num_rows"];
     int mapNumCols = map["num_cols"];
     int tileSize = map["tile_size"];
     double mapScale = map["scale"];
-    std::fstream mapFile;
-    mapFile.open(mapFilePath);
-    for (int y = 0; y < mapNumRows; y++) {
-        for (int x = 0; x < mapNumCols; x++) {
-            char ch;
-            mapFile.get(ch);
-            int srcRectY = std::atoi(&ch) * tileSize;
-            mapFile.get(ch);
-            int srcRectX = std::atoi(&ch) * tileSize;
-            mapFile.ignore();
-
-            Entity tile = registry->CreateEntity();
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)), glm::vec2(mapScale, mapScale), 0.0);
-            tile.AddComponent<SpriteComponent>(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
-        }
-    }
-    mapFile.close();
-    Game::mapWidth = mapNumCols * tileSize * mapScale;
-    Game::mapHeight = mapNumRows * tileSize * mapScale;
+    // Tiles per row of the tileset, the map files hold the index of each tile in the tileset
+    int tilesetNumCols = map["tileset_num_cols"].get_or(10);
+    // Chunks kept in memory around the ones the camera sees, for streamed tilemaps
+    int residencyRadius = map["residency_radius"].get_or(1);
 
-    ////////////////////////////////////////////////////////////////////////////
-    // Read the level entities and their components
-    ////////////////////////////////////////////////////////////////////////////
-    sol::table entities = level["entities"];
-    i = 0;
-    while (true) {
-        sol::optional<sol::table> hasEntity = entities[i];
-        if (hasEntity == sol::nullopt) {
-            break;
+    std::vector<std::string> mapFilePaths = { mapFilePath };
+    const std::string tilemapFilePath = TileLayer::GetTilemapFilePath(mapFilePath);
+    std::error_code error;
+    const auto tilemapTime = std::filesystem::last_write_time(tilemapFilePath, error);
+    const bool hasTilemapFile = !error;
+    const auto mapTime = std::filesystem::last_write_time(mapFilePath, error);
+    if (hasTilemapFile && (error || mapTime <= tilemapTime) && tileLayer.OpenTilemapFile(tilemapFilePath, tileSize, mapScale, mapTexture, residencyRadius)) {
+        Logger::Log("Streaming the tilemap from ", tilemapFilePath);
+        mapFilePaths.push_back(tilemapFilePath);
+    }
+    else {
+        tileLayer.LoadMapFile(mapFilePath, tileSize, mapScale, mapTexture, tilesetNumCols);
+    }
+    if (tileLayer.GetNumRows() != mapNumRows || tileLayer.GetNumCols() != mapNumCols) {
+        Logger::Warn("Map file ", mapFilePath, " has ", tileLayer.GetNumRows(), "x", tileLayer.GetNumCols(), " tiles, the level expects ", mapNumRows, "x", mapNumCols);
+    }
+
+    Game::mapWidth = tileLayer.GetWidth();
+    Game::mapHeight = tileLayer.GetHeight();
+
+    return mapFilePaths;
+}
+
+// Prefabs are instantiated later by the game code or scripts
+static void LoadPrefabs(const sol::table& prefabs, Registry& registry) {
+    for (auto& prefabEntry : prefabs) {
+        const std::string prefabName = prefabEntry.first.as<std::string>();
+        sol::table prefabTable = prefabEntry.second.as<sol::table>();
+        Prefab& prefab = registry.CreatePrefab(prefabName);
+
+        sol::optional<std::string> tag = prefabTable["tag"];
+        if (tag != sol::nullopt) {
+            prefab.Tag(tag.value());
+        }
+
+        sol::optional<std::string> group = prefabTable["group"];
+        if (group != sol::nullopt) {
+            prefab.Group(group.value());
         }
 
+        prefab.SetRecycling(prefabTable["recycle"].get_or(false));
+
+        sol::optional<sol::table> components = prefabTable["components"];
+        if (components != sol::nullopt) {
+            LoadComponents(components.value(), prefab);
+        }
+        Logger::Log("A new prefab was added to the registry, name: " + prefabName);
+    }
+}
+
+static void LoadEntities(const sol::table& level, Registry& registry) {
+    sol::table entities = level["entities"];
+    int numLevelEntities = 0;
+    while (entities[numLevelEntities].get<sol::optional<sol::table>>() != sol::nullopt) {
+        numLevelEntities++;
+    }
+    std::vector<Entity> levelEntities = registry.CreateEntities(numLevelEntities);
+    if (static_cast<int>(levelEntities.size()) < numLevelEntities) {
+        Logger::Err("Only ", levelEntities.size(), " of the ", numLevelEntities, " level entities could be created");
+    }
+
+    for (int i = 0; i < static_cast<int>(levelEntities.size()); i++) {
         sol::table entity = entities[i];
 
-        Entity newEntity = registry->CreateEntity();
+        Entity newEntity = levelEntities[i];
 
         // Tag
         sol::optional<std::string> tag = entity["tag"];
@@ -129,145 +434,343 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
         // Components
         sol::optional<sol::table> hasComponents = entity["components"];
         if (hasComponents != sol::nullopt) {
-            // Transform
-            sol::optional<sol::table> transform = entity["components"]["transform"];
-            if (transform != sol::nullopt) {
-                newEntity.AddComponent<TransformComponent>(
-                    glm::vec2(
-                        entity["components"]["transform"]["position"]["x"],
-                        entity["components"]["transform"]["position"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["transform"]["scale"]["x"].get_or(1.0),
-                        entity["components"]["transform"]["scale"]["y"].get_or(1.0)
-                    ),
-                    entity["components"]["transform"]["rotation"].get_or(0.0)
-                );
-            }
+            LoadComponents(hasComponents.value(), newEntity);
+        }
+    }
+}
 
-            // RigidBody
-            sol::optional<sol::table> rigidbody = entity["components"]["rigidbody"];
-            if (rigidbody != sol::nullopt) {
-                newEntity.AddComponent<RigidBodyComponent>(
-                    glm::vec2(
-                        entity["components"]["rigidbody"]["velocity"]["x"].get_or(0.0),
-                        entity["components"]["rigidbody"]["velocity"]["y"].get_or(0.0)
-                    )
-                );
-            }
+// A dumped function only keeps its code: when it is loaded back its first upvalue is bound to the
+// globals, so the functions can only use globals (through _ENV), not the locals of the level script
+static bool UsesOnlyGlobals(const sol::function& func) {
+    lua_State* L = func.lua_state();
+    func.push();
+    bool usesOnlyGlobals = true;
+    int i = 1;
+    while (const char* upvalueName = lua_getupvalue(L, -1, i)) {
+        lua_pop(L, 1);
+        if (std::string(upvalueName) != "_ENV") {
+            usesOnlyGlobals = false;
+        }
+        i++;
+    }
+    lua_pop(L, 1);
+    return usesOnlyGlobals;
+}
+
+// Reads a compiled level: returns false without changing the Lua globals, the tile layer or the assets
+// when the file is missing, from another version, older than its sources or cannot be read (a snapshot
+// that fails clears the registry). Lua does not verify the script bytecode, so a corrupted file can
+// still load broken scripts.
+static bool LoadCompiledLevel(sol::state& lua, Registry& registry, TileLayer& tileLayer, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, const std::string& compiledLevelPath) {
+    SnapshotReader reader;
+    if (!reader.LoadFromFile(compiledLevelPath)) {
+        return false;
+    }
+
+    uint32_t magic;
+    uint32_t version;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != COMPILED_LEVEL_MAGIC || version != COMPILED_LEVEL_VERSION) {
+        Logger::Warn("Compiled level ", compiledLevelPath, " has another format, it needs to be compiled again");
+        return false;
+    }
+
+    // Files the level was compiled from
+    std::error_code error;
+    const auto compileTime = std::filesystem::last_write_time(compiledLevelPath, error);
+    int32_t count;
+    if (error || !reader.Read(count) || count < 0) {
+        return false;
+    }
+    std::string sourcePath;
+    for (int i = 0; i < count; i++) {
+        if (!reader.ReadString(sourcePath)) {
+            return false;
+        }
+        const auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+        if (!error && sourceTime > compileTime) {
+            Logger::Warn("Compiled level ", compiledLevelPath, " is older than ", sourcePath, ", it needs to be compiled again");
+            return false;
+        }
+    }
 
-            // Audio
-            sol::optional<sol::table> audio = entity["components"]["audio"];
-            if (audio != sol::nullopt) {
-                Logger::Log("Audio component found.");
-                std::string audioAssetId = audio.value().get_or<std::string>("audio_asset_id", "");
-                if (!audioAssetId.empty()) {
-                    Logger::Log("Audio Asset ID: " + audioAssetId);
-                    newEntity.AddComponent<AudioComponent>(audioAssetId, entity["components"]["audio"]["channel"]);
-                }
-                else {
-                    Logger::Log("audio_asset_id is empty.");
-                }
+    // Assets
+    std::vector<LevelAsset> levelAssets;
+    if (!reader.Read(count) || count < 0) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        LevelAsset asset;
+        int32_t fontSize;
+        if (!reader.ReadString(asset.type) || !reader.ReadString(asset.id) || !reader.ReadString(asset.file) || !reader.Read(fontSize)) {
+            return false;
+        }
+        asset.fontSize = fontSize;
+        levelAssets.push_back(asset);
+    }
+
+    TileLayer levelTileLayer;
+    if (!levelTileLayer.Load(reader)) {
+        return false;
+    }
+
+    // Globals the level script defined for the entity scripts, set once the whole level was read
+    if (!reader.Read(count) || count < 0) {
+        return false;
+    }
+    std::vector<std::pair<std::string, sol::object>> levelGlobals;
+    std::string name;
+    for (int i = 0; i < count; i++) {
+        int32_t type;
+        if (!reader.ReadString(name) || !reader.Read(type)) {
+            return false;
+        }
+        if (type == GLOBAL_NUMBER) {
+            double value;
+            if (!reader.Read(value)) {
+                return false;
             }
-            else {
-                Logger::Log("Audio component not found for this entity.");
+            levelGlobals.emplace_back(name, sol::make_object(lua, value));
+        }
+        else if (type == GLOBAL_STRING) {
+            std::string value;
+            if (!reader.ReadString(value)) {
+                return false;
             }
-
-            // Sprite
-            sol::optional<sol::table> sprite = entity["components"]["sprite"];
-            if (sprite != sol::nullopt) {
-                newEntity.AddComponent<SpriteComponent>(
-                    entity["components"]["sprite"]["texture_asset_id"],
-                    entity["components"]["sprite"]["width"],
-                    entity["components"]["sprite"]["height"],
-                    entity["components"]["sprite"]["z_index"].get_or(1),
-                    entity["components"]["sprite"]["fixed"].get_or(false),
-                    entity["components"]["sprite"]["src_rect_x"].get_or(0),
-                    entity["components"]["sprite"]["src_rect_y"].get_or(0)
-                );
+            levelGlobals.emplace_back(name, sol::make_object(lua, value));
+        }
+        else if (type == GLOBAL_BOOLEAN) {
+            uint8_t value;
+            if (!reader.Read(value)) {
+                return false;
             }
+            levelGlobals.emplace_back(name, sol::make_object(lua, value != 0));
+        }
+        else {
+            return false;
+        }
+    }
 
-            // Animation
-            sol::optional<sol::table> animation = entity["components"]["animation"];
-            if (animation != sol::nullopt) {
-                newEntity.AddComponent<AnimationComponent>(
-                    entity["components"]["animation"]["num_frames"].get_or(1),
-                    entity["components"]["animation"]["speed_rate"].get_or(1)
-                );
-            }
+    // Entity scripts, loaded from their precompiled bytecode before anything is added to the registry
+    if (!reader.Read(count) || count < 0) {
+        return false;
+    }
+    std::vector<std::pair<Entity, sol::function>> scripts;
+    for (int i = 0; i < count; i++) {
+        int32_t entityId;
+        int32_t generation;
+        std::string_view bytecode;
+        if (!reader.Read(entityId) || !reader.Read(generation) || !reader.ReadStringView(bytecode)) {
+            return false;
+        }
+        sol::load_result chunk = lua.load_buffer(bytecode.data(), bytecode.size(), compiledLevelPath, sol::load_mode::binary);
+        if (entityId < 0 || entityId >= static_cast<int32_t>(MAX_ENTITIES) || !chunk.valid()) {
+            Logger::Err("Invalid script in compiled level ", compiledLevelPath);
+            return false;
+        }
+        scripts.emplace_back(Entity(entityId, generation), chunk.get<sol::function>());
+    }
 
-            // BoxCollider
-            sol::optional<sol::table> collider = entity["components"]["boxcollider"];
-            if (collider != sol::nullopt) {
-                newEntity.AddComponent<BoxColliderComponent>(
-                    entity["components"]["boxcollider"]["width"],
-                    entity["components"]["boxcollider"]["height"],
-                    glm::vec2(
-                        entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
-                        entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
-                    )
-                );
-            }
+    // Entities and their components, copied straight from the file into the pools
+    if (!registry.LoadSnapshot(reader)) {
+        return false;
+    }
 
-            // Health
-            sol::optional<sol::table> health = entity["components"]["health"];
-            if (health != sol::nullopt) {
-                newEntity.AddComponent<HealthComponent>(
-                    static_cast<int>(entity["components"]["health"]["health_percentage"].get_or(100))
-                );
-            }
+    for (auto& global : levelGlobals) {
+        lua[global.first] = global.second;
+    }
 
-            // ProjectileEmitter
-            sol::optional<sol::table> projectileEmitter = entity["components"]["projectile_emitter"];
-            if (projectileEmitter != sol::nullopt) {
-                newEntity.AddComponent<ProjectileEmitterComponent>(
-                    glm::vec2(
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["x"],
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["y"]
-                    ),
-                    static_cast<int>(entity["components"]["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)) * 1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
-                    entity["components"]["projectile_emitter"]["friendly"].get_or(false)
-                );
-            }
+    for (auto& script : scripts) {
+        if (!registry.IsEntityAlive(script.first)) {
+            Logger::Err("Script of entity id = ", script.first.GetId(), " in compiled level ", compiledLevelPath, " has no entity");
+            continue;
+        }
+        registry.AddComponent<ScriptComponent>(script.first, script.second);
+    }
 
-            // CameraFollow
-            sol::optional<sol::table> cameraFollow = entity["components"]["camera_follow"];
-            if (cameraFollow != sol::nullopt) {
-                newEntity.AddComponent<CameraFollowComponent>();
-            }
+    LoadAssets(levelAssets, assetStore, renderer);
+    tileLayer = std::move(levelTileLayer);
+    Game::mapWidth = tileLayer.GetWidth();
+    Game::mapHeight = tileLayer.GetHeight();
 
-            // KeyboardControlled
-            sol::optional<sol::table> keyboardControlled = entity["components"]["keyboard_controller"];
-            if (keyboardControlled != sol::nullopt) {
-                newEntity.AddComponent<KeyboardControlledComponent>(
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["up_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["up_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["right_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["right_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["down_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["down_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["left_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["left_velocity"]["y"]
-                    )
-                );
-            }
+    Logger::Log("Compiled level loaded from ", compiledLevelPath);
+    return true;
+}
 
-            // Script
-            sol::optional<sol::table> script = entity["components"]["on_update_script"];
-            if (script != sol::nullopt) {
-                sol::function func = entity["components"]["on_update_script"][0];
-                newEntity.AddComponent<ScriptComponent>(func);
-            }
+std::string LevelLoader::GetLevelScriptPath(int levelNumber) {
+    return "./assets/scripts/Level" + std::to_string(levelNumber) + ".lua";
+}
+
+std::string LevelLoader::GetCompiledLevelPath(int levelNumber) {
+    return "./assets/levels/Level" + std::to_string(levelNumber) + ".level";
+}
+
+bool LevelLoader::CompileLevel(int levelNumber) {
+    sol::state lua;
+    lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
+
+    // The globals that exist before the script runs are not part of the level
+    std::unordered_set<std::string> engineGlobals;
+    for (auto& global : lua.globals()) {
+        if (global.first.is<std::string>()) {
+            engineGlobals.insert(global.first.as<std::string>());
         }
-        i++;
     }
-}
\ No newline at end of file
+
+    const std::string scriptPath = GetLevelScriptPath(levelNumber);
+    sol::optional<sol::table> level = RunLevelScript(lua, scriptPath);
+    if (level == sol::nullopt) {
+        Logger::Err("Level ", levelNumber, " cannot be compiled, its script does not define a Level table");
+        return false;
+    }
+    sol::optional<sol::table> prefabs = level.value()["prefabs"];
+    if (prefabs != sol::nullopt) {
+        Logger::Err("Level ", levelNumber, " cannot be compiled, compiled levels do not support prefabs");
+        return false;
+    }
+
+    // Build the level in a registry of its own, the compiled level is a snapshot of it. Levels are
+    // compiled before the game creates its registry, as only one registry can exist at a time.
+    Registry registry;
+    Game::RegisterComponents(registry);
+    const std::vector<LevelAsset> levelAssets = ReadAssets(level.value());
+    TileLayer tileLayer;
+    const std::vector<std::string> mapFilePaths = LoadTilemap(level.value(), tileLayer);
+    LoadEntities(level.value(), registry);
+    registry.Update();
+
+    SnapshotWriter writer;
+    writer.Write(COMPILED_LEVEL_MAGIC);
+    writer.Write(COMPILED_LEVEL_VERSION);
+
+    std::vector<std::string> sourcePaths = { scriptPath };
+    sourcePaths.insert(sourcePaths.end(), mapFilePaths.begin(), mapFilePaths.end());
+    writer.Write(static_cast<int32_t>(sourcePaths.size()));
+    for (auto& sourcePath : sourcePaths) {
+        writer.WriteString(sourcePath);
+    }
+
+    writer.Write(static_cast<int32_t>(levelAssets.size()));
+    for (auto& asset : levelAssets) {
+        writer.WriteString(asset.type);
+        writer.WriteString(asset.id);
+        writer.WriteString(asset.file);
+        writer.Write(static_cast<int32_t>(asset.fontSize));
+    }
+
+    tileLayer.Save(writer);
+
+    // The script values the level computed when it ran are frozen in the compiled level
+    std::vector<std::pair<std::string, sol::object>> levelGlobals;
+    for (auto& global : lua.globals()) {
+        if (!global.first.is<std::string>()) {
+            continue;
+        }
+        const std::string name = global.first.as<std::string>();
+        if (name == "Level" || engineGlobals.count(name) > 0) {
+            continue;
+        }
+        const sol::type type = global.second.get_type();
+        if (type == sol::type::number || type == sol::type::string || type == sol::type::boolean) {
+            levelGlobals.emplace_back(name, global.second);
+        }
+        else {
+            Logger::Warn("Global ", name, " of level ", levelNumber, " is not a number, string or boolean and is not compiled");
+        }
+    }
+    writer.Write(static_cast<int32_t>(levelGlobals.size()));
+    for (auto& global : levelGlobals) {
+        writer.WriteString(global.first);
+        if (global.second.get_type() == sol::type::number) {
+            writer.Write(static_cast<int32_t>(GLOBAL_NUMBER));
+            writer.Write(global.second.as<double>());
+        }
+        else if (global.second.get_type() == sol::type::string) {
+            writer.Write(static_cast<int32_t>(GLOBAL_STRING));
+            writer.WriteString(global.second.as<std::string>());
+        }
+        else {
+            writer.Write(static_cast<int32_t>(GLOBAL_BOOLEAN));
+            writer.Write(static_cast<uint8_t>(global.second.as<bool>() ? 1 : 0));
+        }
+    }
+
+    // Scripts are left out of the snapshot, they are saved as bytecode ahead of it
+    std::vector<std::pair<Entity, sol::bytecode>> scripts;
+    bool areScriptsValid = true;
+    registry.View<ScriptComponent>().Each([&](Entity entity, ScriptComponent& script) {
+        if (!UsesOnlyGlobals(script.func)) {
+            Logger::Err("Script of entity id = ", entity.GetId(), " uses locals of the level script and cannot be compiled");
+            areScriptsValid = false;
+            return;
+        }
+        scripts.emplace_back(entity, script.func.dump());
+    });
+    if (!areScriptsValid) {
+        return false;
+    }
+    writer.Write(static_cast<int32_t>(scripts.size()));
+    for (auto& script : scripts) {
+        writer.Write(static_cast<int32_t>(script.first.GetId()));
+        writer.Write(static_cast<int32_t>(script.first.GetGeneration()));
+        const auto bytecode = script.second.as_string_view();
+        writer.WriteString(std::string(bytecode.data(), bytecode.size()));
+    }
+
+    registry.SaveSnapshot(writer);
+
+    const std::string compiledLevelPath = GetCompiledLevelPath(levelNumber);
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(compiledLevelPath).parent_path(), error);
+    if (!writer.SaveToFile(compiledLevelPath)) {
+        return false;
+    }
+    Logger::Log("Level ", levelNumber, " compiled to ", compiledLevelPath, " (", writer.GetBuffer().size(), " bytes)");
+    return true;
+}
+
+void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, TileLayer& tileLayer, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber) {
+    // Use the compiled level when there is an up to date one, it does not run the Lua interpreter
+    const std::string compiledLevelPath = GetCompiledLevelPath(levelNumber);
+    if (std::filesystem::exists(compiledLevelPath)) {
+        if (LoadCompiledLevel(lua, *registry, tileLayer, assetStore, renderer, compiledLevelPath)) {
+            registry->LogPoolStats();
+            return;
+        }
+        Logger::Warn("Loading level ", levelNumber, " from its script");
+    }
+
+    sol::optional<sol::table> level = RunLevelScript(lua, GetLevelScriptPath(levelNumber));
+    if (level == sol::nullopt) {
+        return;
+    }
+
+    // Optional pool capacity hints, so the pools are allocated once for the whole level
+    sol::optional<sol::table> poolCapacity = level.value()["pool_capacity"];
+    if (poolCapacity != sol::nullopt) {
+        ReservePools(*registry, poolCapacity.value());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the level assets
+    ////////////////////////////////////////////////////////////////////////////
+    LoadAssets(ReadAssets(level.value()), assetStore, renderer);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the level tilemap information
+    ////////////////////////////////////////////////////////////////////////////
+    LoadTilemap(level.value(), tileLayer);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the level prefabs, instantiated later by the game code or scripts
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> prefabs = level.value()["prefabs"];
+    if (prefabs != sol::nullopt) {
+        LoadPrefabs(prefabs.value(), *registry);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the level entities and their components
+    ////////////////////////////////////////////////////////////////////////////
+    LoadEntities(level.value(), *registry);
+    registry->LogPoolStats();
+}
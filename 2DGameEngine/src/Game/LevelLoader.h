@@ -1,7 +1,9 @@
 #pragma once
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Tilemap/TileLayer.h"
 #include <memory>
+#include <string>
 #include <SDL.h>
 #include <sol/sol.hpp>
 
@@ -10,5 +12,13 @@ public:
 	LevelLoader();
 	~LevelLoader();
 
-	void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber);
+	// Loads the compiled image of the level when it is up to date, else runs the level script
+	void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, TileLayer& tileLayer, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber);
+
+	// Runs the level script offline and saves the resulting entities, assets and scripts as a binary image.
+	// Builds the level in a registry of its own, so it must not be called while another registry exists.
+	static bool CompileLevel(int levelNumber);
+
+	static std::string GetLevelScriptPath(int levelNumber);
+	static std::string GetCompiledLevelPath(int levelNumber);
 };
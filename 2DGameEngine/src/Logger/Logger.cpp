@@ -2,31 +2,212 @@
 #include "Logger.h"
 #include <string>
 #include <iostream>
-#include <chrono>
 #include <ctime>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 
-std::vector<LogEntry> Logger::messages;
+////////////////////////////////////////////////////////////////////////////////
+// Bounded multi-producer single-consumer ring buffer: producers claim a slot
+// with a compare-and-swap on the write position, and every slot carries a
+// sequence number telling whether it is ready to be written or read.
+////////////////////////////////////////////////////////////////////////////////
+class LogQueue {
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		LogEntry entry;
+	};
 
+	static const size_t CAPACITY = 4096;
+	std::unique_ptr<Slot[]> slots;
+	std::atomic<size_t> writePosition;
+	size_t readPosition;
 
-std::string CurrentDateTimeToString() {
-	std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-	std::string output(30, '\0');
-	std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S", std::localtime(&now));
+public:
+	LogQueue() : slots(new Slot[CAPACITY]), writePosition(0), readPosition(0) {
+		for (size_t i = 0; i < CAPACITY; i++) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Returns false when the queue is full
+	bool Push(LogEntry& entry) {
+		size_t position = writePosition.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true) {
+			slot = &slots[position % CAPACITY];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+			if (difference == 0) {
+				if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				return false;
+			}
+			else {
+				position = writePosition.load(std::memory_order_relaxed);
+			}
+		}
+		slot->entry = std::move(entry);
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Only called from the sink thread
+	bool Pop(LogEntry& entry) {
+		Slot& slot = slots[readPosition % CAPACITY];
+		if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) {
+			return false;
+		}
+		entry = std::move(slot.entry);
+		slot.sequence.store(readPosition + CAPACITY, std::memory_order_release);
+		readPosition++;
+		return true;
+	}
+};
+
+static std::atomic<int> minLevel(LOGGER_MIN_LEVEL);
+
+static LogQueue logQueue;
+static std::thread sinkThread;
+static std::atomic<bool> isSinkRunning(false);
+static std::mutex sinkMutex;
+static std::condition_variable sinkCondition;
+
+// Producers that may push to the queue, counted before they check isSinkRunning, so Stop() waits for
+// their push before its last drain
+static std::atomic<int> numWritersInFlight(0);
+
+// Serializes the direct writes, and the history accesses
+static std::mutex logMutex;
+static std::deque<LogEntry> history;
+
+// Makes sure the sink thread is joined even if Stop() was never called
+static struct SinkGuard {
+	~SinkGuard() {
+		Logger::Stop();
+	}
+} sinkGuard;
+
+static std::string DateTimeToString(std::chrono::system_clock::time_point time) {
+	std::time_t now = std::chrono::system_clock::to_time_t(time);
+	char output[30];
+	std::strftime(output, sizeof(output), "%d-%b-%Y %H:%M:%S", std::localtime(&now));
 	return output;
 }
 
-void Logger::Log(const std::string& message) {
-	LogEntry logEntry;
-	logEntry.type = LOG_INFO;
-	logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
-	messages.push_back(logEntry);
-	std::cout << "\x1B[32m" << logEntry.message << "\033[0m" << std::endl;
+// Writes the entry to the console (without flushing) and keeps it in the history
+static void Print(LogEntry& entry) {
+	static const char* prefixes[] = { "DBG", "LOG", "WRN", "ERR" };
+	static const char* colors[] = { "\x1B[90m", "\x1B[32m", "\x1B[93m", "\x1B[91m" };
+	std::cout << colors[entry.type] << prefixes[entry.type] << ": [" << DateTimeToString(entry.time) << "]: " << entry.message << "\033[0m\n";
+
+	history.push_back(std::move(entry));
+	if (history.size() > Logger::MAX_HISTORY) {
+		history.pop_front();
+	}
+}
+
+static void SinkLoop() {
+	LogEntry entry;
+	while (true) {
+		bool hasWritten = false;
+		{
+			std::lock_guard<std::mutex> lock(logMutex);
+			while (logQueue.Pop(entry)) {
+				Print(entry);
+				hasWritten = true;
+			}
+		}
+		if (hasWritten) {
+			std::cout.flush();
+			continue;
+		}
+		if (!isSinkRunning) {
+			return;
+		}
+
+		// Producers do not lock anything, so the sink also wakes up on its own to poll the queue
+		std::unique_lock<std::mutex> lock(sinkMutex);
+		sinkCondition.wait_for(lock, std::chrono::milliseconds(5));
+	}
+}
+
+void Logger::Start() {
+	if (isSinkRunning.exchange(true)) {
+		return;
+	}
+	sinkThread = std::thread(SinkLoop);
 }
 
-void Logger::Err(const std::string& message) {
-	LogEntry logEntry;
-	logEntry.type = LOG_ERROR;
-	logEntry.message = "ERR: [" + CurrentDateTimeToString() + "]: " + message;
-	messages.push_back(logEntry);
-	std::cout << "\x1B[91m" << logEntry.message << "\033[0m" << std::endl;
-}
\ No newline at end of file
+void Logger::Stop() {
+	if (!isSinkRunning.exchange(false)) {
+		return;
+	}
+	sinkCondition.notify_one();
+	sinkThread.join();
+
+	// A producer that saw the sink running may still be pushing, and once isSinkRunning is false the
+	// ones waiting on a full queue give up and write directly
+	while (numWritersInFlight.load() > 0) {
+		std::this_thread::yield();
+	}
+
+	// Write whatever was queued while the sink was shutting down
+	std::lock_guard<std::mutex> lock(logMutex);
+	LogEntry entry;
+	while (logQueue.Pop(entry)) {
+		Print(entry);
+	}
+	std::cout.flush();
+}
+
+void Logger::SetLevel(LogType type) {
+	minLevel = type;
+}
+
+bool Logger::IsEnabled(LogType type) {
+	return type >= LOGGER_MIN_LEVEL && type >= minLevel.load(std::memory_order_relaxed);
+}
+
+std::vector<LogEntry> Logger::GetMessages() {
+	std::lock_guard<std::mutex> lock(logMutex);
+	return std::vector<LogEntry>(history.begin(), history.end());
+}
+
+void Logger::Write(LogType type, std::string message) {
+	LogEntry entry;
+	entry.type = type;
+	entry.time = std::chrono::system_clock::now();
+	entry.message = std::move(message);
+
+	numWritersInFlight++;
+	bool isQueued = false;
+	if (isSinkRunning) {
+		// When the queue is full, wait for the sink to make room rather than dropping the message
+		isQueued = logQueue.Push(entry);
+		while (!isQueued && isSinkRunning) {
+			sinkCondition.notify_one();
+			std::this_thread::yield();
+			isQueued = logQueue.Push(entry);
+		}
+	}
+	numWritersInFlight--;
+	if (isQueued) {
+		if (type == LOG_ERROR) {
+			sinkCondition.notify_one();
+		}
+		return;
+	}
+
+	// No sink thread, write the message right away
+	std::lock_guard<std::mutex> lock(logMutex);
+	Print(entry);
+	std::cout.flush();
+}
@@ -1,22 +1,109 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <sstream>
+#include <chrono>
+#include <type_traits>
 
 enum LogType {
+	LOG_DEBUG,
 	LOG_INFO,
 	LOG_WARNING,
 	LOG_ERROR
 };
 
+// Messages below this level are compiled out entirely (e.g. define LOGGER_MIN_LEVEL=LOG_WARNING)
+#ifndef LOGGER_MIN_LEVEL
+#ifdef NDEBUG
+#define LOGGER_MIN_LEVEL LOG_INFO
+#else
+#define LOGGER_MIN_LEVEL LOG_DEBUG
+#endif
+#endif
+
 struct LogEntry {
 	LogType type;
+	std::chrono::system_clock::time_point time;
 	std::string message;
 };
 
-
+////////////////////////////////////////////////////////////////////////////////
+// Logger
+////////////////////////////////////////////////////////////////////////////////
+// Messages are only formatted when their level is enabled, then pushed to a
+// lock-free ring buffer and written to the console by a background sink
+// thread. Until Start() is called (and after Stop()) messages are written
+// directly by the calling thread. Only the last MAX_HISTORY messages are
+// kept in memory.
+////////////////////////////////////////////////////////////////////////////////
 class Logger {
+private:
+	static void Write(LogType type, std::string message);
+
+	static void Append(std::string& message, const std::string& value) { message += value; }
+	static void Append(std::string& message, const char* value) { message += value; }
+	static void Append(std::string& message, char value) { message += value; }
+
+	template <typename T>
+	static void Append(std::string& message, const T& value) {
+		if constexpr (std::is_arithmetic_v<T>) {
+			message += std::to_string(value);
+		}
+		else {
+			std::ostringstream stream;
+			stream << value;
+			message += stream.str();
+		}
+	}
+
+	template <typename ...TArgs>
+	static void Format(LogType type, const TArgs& ...args) {
+		if (!IsEnabled(type)) {
+			return;
+		}
+		std::string message;
+		(Append(message, args), ...);
+		Write(type, std::move(message));
+	}
+
 public:
-	static std::vector<LogEntry> messages;
-	static void Log(const std::string& message);
-	static void Err(const std::string& message);
-};
\ No newline at end of file
+	static const int MAX_HISTORY = 1024;
+
+	// Starts and stops the background sink thread, which writes every pending message before stopping
+	static void Start();
+	static void Stop();
+
+	// Runtime minimum level, on top of LOGGER_MIN_LEVEL
+	static void SetLevel(LogType type);
+	static bool IsEnabled(LogType type);
+
+	// Copy of the most recent messages, oldest first
+	static std::vector<LogEntry> GetMessages();
+
+	// The arguments are streamed together, e.g. Logger::Log("Entity id = ", entity.GetId())
+	template <typename ...TArgs>
+	static void Debug(const TArgs& ...args) {
+		if constexpr (LOG_DEBUG >= LOGGER_MIN_LEVEL) {
+			Format(LOG_DEBUG, args...);
+		}
+	}
+
+	template <typename ...TArgs>
+	static void Log(const TArgs& ...args) {
+		if constexpr (LOG_INFO >= LOGGER_MIN_LEVEL) {
+			Format(LOG_INFO, args...);
+		}
+	}
+
+	template <typename ...TArgs>
+	static void Warn(const TArgs& ...args) {
+		if constexpr (LOG_WARNING >= LOGGER_MIN_LEVEL) {
+			Format(LOG_WARNING, args...);
+		}
+	}
+
+	template <typename ...TArgs>
+	static void Err(const TArgs& ...args) {
+		Format(LOG_ERROR, args...);
+	}
+};
@@ -1,14 +1,41 @@
 #include "./Game/Game.h"
+#include "./Game/LevelLoader.h"
+#include "./Tilemap/TileLayer.h"
 #include <sol/sol.hpp>
 #include <iostream>
+#include <string>
+#include <cstdlib>
 
 
 int main(int argc, char* argv[]) {
+    // Write the log messages from a background thread while the game runs
+    Logger::Start();
+
+    // "--compile-level 1 2" compiles the given levels to binary images and exits without running the game
+    if (argc > 1 && std::string(argv[1]) == "--compile-level") {
+        bool isCompiled = argc > 2;
+        for (int i = 2; i < argc; i++) {
+            isCompiled = LevelLoader::CompileLevel(std::atoi(argv[i])) && isCompiled;
+        }
+        Logger::Stop();
+        return isCompiled ? 0 : 1;
+    }
+
+    // "--convert-map file.map [tileset_num_cols]" converts a text map to the binary tilemap streamed by the game
+    if (argc > 2 && std::string(argv[1]) == "--convert-map") {
+        const int tilesetNumCols = argc > 3 ? std::atoi(argv[3]) : 10;
+        const bool isConverted = TileLayer::ConvertMapFile(argv[2], TileLayer::GetTilemapFilePath(argv[2]), tilesetNumCols);
+        Logger::Stop();
+        return isConverted ? 0 : 1;
+    }
+
     Game game;
 
     game.Initialize();
     game.Run();
     game.Destroy();
 
+    Logger::Stop();
+
     return 0;
 }
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+// ColliderBounds
+////////////////////////////////////////////////////////////////////////////////
+// Axis aligned boxes stored as one float array per side (structure of
+// arrays), so the narrowphase loads the same side of several boxes with a
+// single vector instruction. The max sides are exclusive: boxes that only
+// touch do not overlap. Each box also has its collision layer bit and the
+// mask of the layers it collides with.
+////////////////////////////////////////////////////////////////////////////////
+struct ColliderBounds {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<uint32_t> layers;
+    std::vector<uint32_t> masks;
+
+    int GetSize() const {
+        return static_cast<int>(minX.size());
+    }
+
+    void Clear() {
+        minX.clear();
+        minY.clear();
+        maxX.clear();
+        maxY.clear();
+        layers.clear();
+        masks.clear();
+    }
+
+    void Reserve(int size) {
+        minX.reserve(size);
+        minY.reserve(size);
+        maxX.reserve(size);
+        maxY.reserve(size);
+        layers.reserve(size);
+        masks.reserve(size);
+    }
+
+    void Add(float boxMinX, float boxMinY, float boxMaxX, float boxMaxY, uint32_t layer, uint32_t mask) {
+        minX.push_back(boxMinX);
+        minY.push_back(boxMinY);
+        maxX.push_back(boxMaxX);
+        maxY.push_back(boxMaxY);
+        layers.push_back(layer);
+        masks.push_back(mask);
+    }
+
+    // Both boxes must have the layer of the other one in their mask
+    bool CanCollide(int a, int b) const {
+        return (layers[a] & masks[b]) != 0 && (layers[b] & masks[a]) != 0;
+    }
+
+    bool Overlap(int a, int b) const {
+        return minX[a] < maxX[b] && maxX[a] > minX[b] && minY[a] < maxY[b] && maxY[a] > minY[b];
+    }
+};
@@ -0,0 +1,171 @@
+#include "Narrowphase.h"
+
+#if !defined(NARROWPHASE_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define NARROWPHASE_AVX2
+#elif !defined(NARROWPHASE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define NARROWPHASE_SSE2
+#endif
+
+#if defined(NARROWPHASE_AVX2)
+
+static const int BATCH_SIZE = 8;
+typedef __m256 Batch;
+
+static Batch Broadcast(float value) {
+    return _mm256_set1_ps(value);
+}
+
+static Batch Load(const float* values) {
+    return _mm256_loadu_ps(values);
+}
+
+static Batch Gather(const float* values, const int* indices) {
+    return _mm256_i32gather_ps(values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), sizeof(float));
+}
+
+// One bit per box of the batch that overlaps the box a
+static int OverlapMask(Batch aMinX, Batch aMinY, Batch aMaxX, Batch aMaxY, Batch bMinX, Batch bMinY, Batch bMaxX, Batch bMaxY) {
+    const Batch overlapX = _mm256_and_ps(_mm256_cmp_ps(aMinX, bMaxX, _CMP_LT_OQ), _mm256_cmp_ps(aMaxX, bMinX, _CMP_GT_OQ));
+    const Batch overlapY = _mm256_and_ps(_mm256_cmp_ps(aMinY, bMaxY, _CMP_LT_OQ), _mm256_cmp_ps(aMaxY, bMinY, _CMP_GT_OQ));
+    return _mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY));
+}
+
+// One bit per box of the batch whose layers can collide with the box a
+static int LayerMask(__m256i aLayer, __m256i aMask, const uint32_t* layers, const uint32_t* masks) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bLayer = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(layers));
+    const __m256i bMask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks));
+    const __m256i rejected = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_and_si256(aLayer, bMask), zero), _mm256_cmpeq_epi32(_mm256_and_si256(bLayer, aMask), zero));
+    return ~_mm256_movemask_ps(_mm256_castsi256_ps(rejected)) & 0xFF;
+}
+
+static __m256i BroadcastLayer(uint32_t value) {
+    return _mm256_set1_epi32(static_cast<int>(value));
+}
+
+#elif defined(NARROWPHASE_SSE2)
+
+static const int BATCH_SIZE = 4;
+typedef __m128 Batch;
+
+static Batch Broadcast(float value) {
+    return _mm_set1_ps(value);
+}
+
+static Batch Load(const float* values) {
+    return _mm_loadu_ps(values);
+}
+
+// SSE2 has no gather instruction, the boxes are loaded one by one
+static Batch Gather(const float* values, const int* indices) {
+    return _mm_setr_ps(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+}
+
+// One bit per box of the batch that overlaps the box a
+static int OverlapMask(Batch aMinX, Batch aMinY, Batch aMaxX, Batch aMaxY, Batch bMinX, Batch bMinY, Batch bMaxX, Batch bMaxY) {
+    const Batch overlapX = _mm_and_ps(_mm_cmplt_ps(aMinX, bMaxX), _mm_cmpgt_ps(aMaxX, bMinX));
+    const Batch overlapY = _mm_and_ps(_mm_cmplt_ps(aMinY, bMaxY), _mm_cmpgt_ps(aMaxY, bMinY));
+    return _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+}
+
+// One bit per box of the batch whose layers can collide with the box a
+static int LayerMask(__m128i aLayer, __m128i aMask, const uint32_t* layers, const uint32_t* masks) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bLayer = _mm_loadu_si128(reinterpret_cast<const __m128i*>(layers));
+    const __m128i bMask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks));
+    const __m128i rejected = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(aLayer, bMask), zero), _mm_cmpeq_epi32(_mm_and_si128(bLayer, aMask), zero));
+    return ~_mm_movemask_ps(_mm_castsi128_ps(rejected)) & 0xF;
+}
+
+static __m128i BroadcastLayer(uint32_t value) {
+    return _mm_set1_epi32(static_cast<int>(value));
+}
+
+#endif
+
+void Narrowphase::FindOverlaps(const ColliderBounds& bounds, std::vector<std::pair<int, int>>& pairs) {
+    pairs.clear();
+    const int numBoxes = bounds.GetSize();
+    for (int a = 0; a < numBoxes; a++) {
+        int b = a + 1;
+
+#if defined(NARROWPHASE_AVX2) || defined(NARROWPHASE_SSE2)
+        const Batch aMinX = Broadcast(bounds.minX[a]);
+        const Batch aMinY = Broadcast(bounds.minY[a]);
+        const Batch aMaxX = Broadcast(bounds.maxX[a]);
+        const Batch aMaxY = Broadcast(bounds.maxY[a]);
+        const auto aLayer = BroadcastLayer(bounds.layers[a]);
+        const auto aMask = BroadcastLayer(bounds.masks[a]);
+        for (; b + BATCH_SIZE <= numBoxes; b += BATCH_SIZE) {
+            // The boxes of layers that cannot collide are rejected before the overlap test
+            const int layerMask = LayerMask(aLayer, aMask, &bounds.layers[b], &bounds.masks[b]);
+            if (layerMask == 0) {
+                continue;
+            }
+            int mask = layerMask & OverlapMask(
+                aMinX, aMinY, aMaxX, aMaxY,
+                Load(&bounds.minX[b]), Load(&bounds.minY[b]), Load(&bounds.maxX[b]), Load(&bounds.maxY[b])
+            );
+            for (int i = 0; mask != 0; i++, mask >>= 1) {
+                if (mask & 1) {
+                    pairs.emplace_back(a, b + i);
+                }
+            }
+        }
+#endif
+
+        // Boxes left after the last full batch
+        for (; b < numBoxes; b++) {
+            if (bounds.CanCollide(a, b) && bounds.Overlap(a, b)) {
+                pairs.emplace_back(a, b);
+            }
+        }
+    }
+}
+
+void Narrowphase::FilterOverlaps(const ColliderBounds& bounds, const std::vector<std::pair<int, int>>& candidates, std::vector<std::pair<int, int>>& pairs) {
+    pairs.clear();
+    const int numCandidates = static_cast<int>(candidates.size());
+    int first = 0;
+    while (first < numCandidates) {
+        // Candidates of the same box a are tested together
+        const int a = candidates[first].first;
+        int end = first + 1;
+        while (end < numCandidates && candidates[end].first == a) {
+            end++;
+        }
+        int candidate = first;
+
+#if defined(NARROWPHASE_AVX2) || defined(NARROWPHASE_SSE2)
+        const Batch aMinX = Broadcast(bounds.minX[a]);
+        const Batch aMinY = Broadcast(bounds.minY[a]);
+        const Batch aMaxX = Broadcast(bounds.maxX[a]);
+        const Batch aMaxY = Broadcast(bounds.maxY[a]);
+        int indices[BATCH_SIZE];
+        for (; candidate + BATCH_SIZE <= end; candidate += BATCH_SIZE) {
+            for (int i = 0; i < BATCH_SIZE; i++) {
+                indices[i] = candidates[candidate + i].second;
+            }
+            int mask = OverlapMask(
+                aMinX, aMinY, aMaxX, aMaxY,
+                Gather(bounds.minX.data(), indices), Gather(bounds.minY.data(), indices), Gather(bounds.maxX.data(), indices), Gather(bounds.maxY.data(), indices)
+            );
+            for (int i = 0; mask != 0; i++, mask >>= 1) {
+                if (mask & 1) {
+                    pairs.emplace_back(a, indices[i]);
+                }
+            }
+        }
+#endif
+
+        // Candidates left after the last full batch
+        for (; candidate < end; candidate++) {
+            if (bounds.Overlap(a, candidates[candidate].second)) {
+                pairs.push_back(candidates[candidate]);
+            }
+        }
+        first = end;
+    }
+}
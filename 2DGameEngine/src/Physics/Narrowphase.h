@@ -0,0 +1,24 @@
+#pragma once
+#include "ColliderBounds.h"
+#include <vector>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+// Narrowphase
+////////////////////////////////////////////////////////////////////////////////
+// Overlap tests of one box against a batch of boxes at a time: 8 boxes per
+// instruction with AVX2, 4 with SSE2 (always available on x64), and one at a
+// time when NARROWPHASE_NO_SIMD is defined or on other architectures. Only
+// the overlapping pairs are appended to the output, in the order of their
+// indices, so all the paths give the same result.
+////////////////////////////////////////////////////////////////////////////////
+class Narrowphase {
+public:
+    // Tests every pair of boxes whose layers can collide, without broadphase. Faster than a broadphase up
+    // to about 128 boxes with SSE2.
+    static void FindOverlaps(const ColliderBounds& bounds, std::vector<std::pair<int, int>>& pairs);
+
+    // Tests the candidate pairs of a broadphase, which must be grouped by their first box. The broadphase
+    // already dropped the pairs whose layers cannot collide.
+    static void FilterOverlaps(const ColliderBounds& bounds, const std::vector<std::pair<int, int>>& candidates, std::vector<std::pair<int, int>>& pairs);
+};
@@ -0,0 +1,91 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(double cellSize) : cellSize(cellSize) {
+}
+
+void SpatialHash::SetCellSize(double cellSize) {
+    this->cellSize = cellSize;
+}
+
+double SpatialHash::GetCellSize() const {
+    return cellSize;
+}
+
+int SpatialHash::GetCell(double position) const {
+    return static_cast<int>(std::floor(position / cellSize));
+}
+
+void SpatialHash::FindPairs(const ColliderBounds& bounds, std::vector<std::pair<int, int>>& pairs) {
+    pairs.clear();
+    const int numBoxes = bounds.GetSize();
+
+    // Insert every box in all the cells it overlaps
+    entries.clear();
+    firstCellX.resize(numBoxes);
+    firstCellY.resize(numBoxes);
+    for (int i = 0; i < numBoxes; i++) {
+        const int cellX0 = GetCell(bounds.minX[i]);
+        const int cellY0 = GetCell(bounds.minY[i]);
+        const int cellX1 = GetCell(bounds.maxX[i]);
+        const int cellY1 = GetCell(bounds.maxY[i]);
+        firstCellX[i] = cellX0;
+        firstCellY[i] = cellY0;
+        for (int cellY = cellY0; cellY <= cellY1; cellY++) {
+            for (int cellX = cellX0; cellX <= cellX1; cellX++) {
+                entries.push_back({ cellX, cellY, i });
+            }
+        }
+    }
+
+    // Group the entries by bucket, there are at least twice as many buckets as entries
+    size_t numBuckets = 2;
+    while (numBuckets < entries.size() * 2) {
+        numBuckets *= 2;
+    }
+    const uint32_t bucketMask = static_cast<uint32_t>(numBuckets - 1);
+    auto getBucket = [bucketMask](const CellEntry& entry) {
+        return ((static_cast<uint32_t>(entry.cellX) * 73856093u) ^ (static_cast<uint32_t>(entry.cellY) * 19349663u)) & bucketMask;
+    };
+
+    bucketStarts.assign(numBuckets + 1, 0);
+    for (auto& entry : entries) {
+        bucketStarts[getBucket(entry) + 1]++;
+    }
+    for (size_t bucket = 0; bucket < numBuckets; bucket++) {
+        bucketStarts[bucket + 1] += bucketStarts[bucket];
+    }
+    sortedEntries.resize(entries.size());
+    for (auto& entry : entries) {
+        sortedEntries[bucketStarts[getBucket(entry)]++] = entry;
+    }
+    // The fill moved every start to the end of its bucket, which is the start of the next one
+    for (size_t bucket = numBuckets; bucket > 0; bucket--) {
+        bucketStarts[bucket] = bucketStarts[bucket - 1];
+    }
+    bucketStarts[0] = 0;
+
+    // Pair the boxes of each cell. Two boxes can share several cells, the pair is only kept in the
+    // first cell of their common range, the one with the highest first cell of the two boxes.
+    for (size_t bucket = 0; bucket < numBuckets; bucket++) {
+        const int bucketEnd = bucketStarts[bucket + 1];
+        for (int i = bucketStarts[bucket]; i < bucketEnd; i++) {
+            const CellEntry& a = sortedEntries[i];
+            for (int j = i + 1; j < bucketEnd; j++) {
+                const CellEntry& b = sortedEntries[j];
+                if (a.cellX != b.cellX || a.cellY != b.cellY || !bounds.CanCollide(a.boxIndex, b.boxIndex)) {
+                    continue;
+                }
+                if (std::max(firstCellX[a.boxIndex], firstCellX[b.boxIndex]) != a.cellX ||
+                    std::max(firstCellY[a.boxIndex], firstCellY[b.boxIndex]) != a.cellY) {
+                    continue;
+                }
+                pairs.emplace_back(a.boxIndex, b.boxIndex);
+            }
+        }
+    }
+
+    // The boxes are inserted in order, so the first box of every pair already has the lower index
+    std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "ColliderBounds.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+// SpatialHash
+////////////////////////////////////////////////////////////////////////////////
+// Broadphase that puts the boxes in the cells of a uniform grid they overlap,
+// and hashes the cells into buckets, so the grid does not need bounds and its
+// memory only depends on the number of boxes. It is rebuilt from scratch for
+// every query with two passes of a counting sort, which is linear in the
+// number of boxes and reuses its buffers from frame to frame.
+//
+// The cell size should be about the size of the common boxes: smaller cells
+// put the boxes in more cells, bigger cells give more candidates per cell.
+////////////////////////////////////////////////////////////////////////////////
+class SpatialHash {
+private:
+    struct CellEntry {
+        int cellX;
+        int cellY;
+        int boxIndex;
+    };
+
+    double cellSize;
+    std::vector<CellEntry> entries;
+    std::vector<CellEntry> sortedEntries;
+    std::vector<int> bucketStarts;
+    std::vector<int> firstCellX;
+    std::vector<int> firstCellY;
+
+    int GetCell(double position) const;
+
+public:
+    explicit SpatialHash(double cellSize = 64.0);
+
+    void SetCellSize(double cellSize);
+    double GetCellSize() const;
+
+    // Finds the pairs of boxes that share a cell and whose layers can collide, each pair once as (lower
+    // index, higher index), sorted by the first and then by the second index. Boxes in the same cell
+    // may still not overlap.
+    void FindPairs(const ColliderBounds& bounds, std::vector<std::pair<int, int>>& pairs);
+};
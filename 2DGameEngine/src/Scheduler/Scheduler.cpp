@@ -0,0 +1,99 @@
+#include "Scheduler.h"
+#include "../Logger/Logger.h"
+#include <mutex>
+#include <condition_variable>
+
+Scheduler::Scheduler(ThreadPool& threadPool) : threadPool(threadPool) {
+    Logger::Log("Scheduler created with ", threadPool.GetNumThreads(), " worker threads");
+}
+
+Scheduler::~Scheduler() {
+    Logger::Log("Scheduler destroyed");
+}
+
+void Scheduler::AddJob(const System& system, std::function<void()> func) {
+    Job job;
+    job.readSignature = system.GetReadSignature();
+    job.writeSignature = system.GetWriteSignature();
+    job.isExclusive = system.IsExclusive();
+    job.func = std::move(func);
+    jobs.push_back(std::move(job));
+}
+
+bool Scheduler::IsConflicting(const Job& a, const Job& b) {
+    if (a.isExclusive || b.isExclusive) {
+        return true;
+    }
+    return a.writeSignature.Intersects(b.readSignature | b.writeSignature) || b.writeSignature.Intersects(a.readSignature);
+}
+
+void Scheduler::Run() {
+    const int numJobs = static_cast<int>(jobs.size());
+
+    // Build the dependency graph: a job waits for every earlier job it conflicts with
+    std::vector<int> numDependencies(numJobs, 0);
+    std::vector<std::vector<int>> dependents(numJobs);
+    for (int j = 0; j < numJobs; j++) {
+        for (int i = 0; i < j; i++) {
+            if (IsConflicting(jobs[i], jobs[j])) {
+                dependents[i].push_back(j);
+                numDependencies[j]++;
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable jobCompleted;
+    std::vector<int> readyJobs;
+    int numCompletedJobs = 0;
+
+    for (int j = 0; j < numJobs; j++) {
+        if (numDependencies[j] == 0) {
+            readyJobs.push_back(j);
+        }
+    }
+
+    auto completeJob = [&](int j) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto dependent : dependents[j]) {
+            if (--numDependencies[dependent] == 0) {
+                readyJobs.push_back(dependent);
+            }
+        }
+        numCompletedJobs++;
+        jobCompleted.notify_all();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (numCompletedJobs < numJobs) {
+        if (readyJobs.empty()) {
+            // Help the workers while waiting, or sleep until some job completes
+            lock.unlock();
+            const bool hasRunTask = threadPool.RunPendingTask();
+            lock.lock();
+            if (!hasRunTask && readyJobs.empty() && numCompletedJobs < numJobs) {
+                jobCompleted.wait(lock);
+            }
+            continue;
+        }
+
+        std::vector<int> jobsToStart;
+        jobsToStart.swap(readyJobs);
+        lock.unlock();
+        for (auto j : jobsToStart) {
+            if (jobs[j].isExclusive) {
+                jobs[j].func();
+                completeJob(j);
+            }
+            else {
+                threadPool.Submit([this, j, &completeJob]() {
+                    jobs[j].func();
+                    completeJob(j);
+                });
+            }
+        }
+        lock.lock();
+    }
+
+    jobs.clear();
+}
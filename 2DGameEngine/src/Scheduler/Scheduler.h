@@ -0,0 +1,39 @@
+#pragma once
+#include "../ECS/ECS.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <functional>
+
+////////////////////////////////////////////////////////////////////////////////
+// Scheduler
+////////////////////////////////////////////////////////////////////////////////
+// The scheduler runs the system updates of a frame on the thread pool. Every
+// job carries the components its system reads and writes. A job depends on every
+// earlier job it conflicts with (one of them writes what the other reads or
+// writes), and jobs without a path between them in that graph run concurrently.
+// Exclusive jobs conflict with everything and always run on the calling thread.
+////////////////////////////////////////////////////////////////////////////////
+class Scheduler {
+private:
+    struct Job {
+        Signature readSignature;
+        Signature writeSignature;
+        bool isExclusive;
+        std::function<void()> func;
+    };
+
+    ThreadPool& threadPool;
+    std::vector<Job> jobs;
+
+    static bool IsConflicting(const Job& a, const Job& b);
+
+public:
+    Scheduler(ThreadPool& threadPool);
+    ~Scheduler();
+
+    // Adds the update of a system to the current frame, using the component access declared by the system
+    void AddJob(const System& system, std::function<void()> func);
+
+    // Builds the dependency graph of the jobs added since the last Run(), runs them and waits for all of them
+    void Run();
+};
@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// Index of the worker running on the current thread, -1 for threads outside the pool
+static thread_local int currentWorkerIndex = -1;
+
+ThreadPool::ThreadPool(int numThreads) : numPendingTasks(0), isRunning(true), nextQueue(0) {
+    for (int i = 0; i < numThreads; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        isRunning = false;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::GetNumThreads() const {
+    return static_cast<int>(workers.size());
+}
+
+int ThreadPool::GetDefaultNumThreads() {
+    const int numCores = static_cast<int>(std::thread::hardware_concurrency());
+    return numCores > 1 ? numCores - 1 : 0;
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    // Without workers the task simply runs on the submitting thread
+    if (queues.empty()) {
+        task();
+        return;
+    }
+
+    const int queueIndex = currentWorkerIndex != -1 ? currentWorkerIndex : static_cast<int>(nextQueue++ % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        numPendingTasks++;
+    }
+    wakeCondition.notify_one();
+}
+
+bool ThreadPool::PopTask(int queueIndex, std::function<void()>& task) {
+    const int numQueues = static_cast<int>(queues.size());
+
+    // Take the newest task from our own queue first
+    if (queueIndex != -1) {
+        auto& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            numPendingTasks--;
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task from another queue
+    for (int i = 1; i <= numQueues; i++) {
+        const int victimIndex = ((queueIndex == -1 ? 0 : queueIndex) + i) % numQueues;
+        auto& queue = *queues[victimIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            numPendingTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::RunPendingTask() {
+    if (queues.empty()) {
+        return false;
+    }
+    std::function<void()> task;
+    if (!PopTask(currentWorkerIndex, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::ParallelFor(int count, int chunkSize, const std::function<void(int, int)>& func) {
+    if (count <= 0) {
+        return;
+    }
+    chunkSize = chunkSize > 0 ? chunkSize : 1;
+    const int numChunks = (count + chunkSize - 1) / chunkSize;
+
+    // Nothing to split, or nobody to share the work with
+    if (numChunks == 1 || queues.empty()) {
+        for (int begin = 0; begin < count; begin += chunkSize) {
+            func(begin, std::min(begin + chunkSize, count));
+        }
+        return;
+    }
+
+    // The first chunk is kept for the calling thread, the rest go to the workers
+    std::atomic<int> numRemainingChunks(numChunks - 1);
+    for (int chunk = 1; chunk < numChunks; chunk++) {
+        const int begin = chunk * chunkSize;
+        const int end = std::min(begin + chunkSize, count);
+        Submit([&func, &numRemainingChunks, begin, end]() {
+            func(begin, end);
+            numRemainingChunks--;
+        });
+    }
+    func(0, std::min(chunkSize, count));
+
+    // Help with the pending chunks (or any other task) until all of ours are done
+    while (numRemainingChunks > 0) {
+        if (!RunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop(int workerIndex) {
+    currentWorkerIndex = workerIndex;
+    while (true) {
+        std::function<void()> task;
+        if (PopTask(workerIndex, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() { return !isRunning || numPendingTasks > 0; });
+        if (!isRunning && numPendingTasks == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+// ThreadPool
+////////////////////////////////////////////////////////////////////////////////
+// A work-stealing thread pool. Every worker owns a queue of tasks: it pops the
+// newest task from its own queue, and when it runs out of work it steals the
+// oldest task from the queue of another worker.
+////////////////////////////////////////////////////////////////////////////////
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    // Sleeping workers are woken up when new tasks are submitted
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<int> numPendingTasks;
+    std::atomic<bool> isRunning;
+    std::atomic<unsigned int> nextQueue;
+
+    void WorkerLoop(int workerIndex);
+    bool PopTask(int queueIndex, std::function<void()>& task);
+
+public:
+    // Creates numThreads workers (zero workers runs every task on the submitting thread)
+    ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    int GetNumThreads() const;
+
+    // Queues a task on the queue of the calling worker, or on the next queue in round-robin order
+    void Submit(std::function<void()> task);
+
+    // Runs one pending task on the calling thread, so a waiting thread can help the workers
+    bool RunPendingTask();
+
+    // Splits [0, count) in chunks of chunkSize and invokes func(begin, end) for each chunk, with the
+    // calling thread helping the workers until every chunk is done. Chunk boundaries only depend on
+    // count and chunkSize, never on the number of threads.
+    void ParallelFor(int count, int chunkSize, const std::function<void(int, int)>& func);
+
+    // Returns a sensible default worker count, leaving one core for the main thread
+    static int GetDefaultNumThreads();
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "../ECS/ECS.h"
+#include "../Scheduler/ThreadPool.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/AnimationComponent.h"
 #include <SDL.h>
@@ -9,15 +10,20 @@ public:
 	AnimationSystem() {
 		RequireComponent<SpriteComponent>();
 		RequireComponent<AnimationComponent>();
+		WritesComponent<SpriteComponent>();
+		WritesComponent<AnimationComponent>();
 	}
 
-	void Update() {
-		for (Entity entity : GetSystemEntities()) {
-			auto& animation = entity.GetComponent<AnimationComponent>();
-			auto& sprite = entity.GetComponent<SpriteComponent>();
-
-			animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
+	void Update(std::unique_ptr<Registry>& registry, ThreadPool& threadPool) {
+		const int ticks = SDL_GetTicks();
+		const int chunkSize = 1024;
+		auto view = registry->View<AnimationComponent, SpriteComponent>();
+		auto animate = [ticks](Entity, AnimationComponent& animation, SpriteComponent& sprite) {
+			animation.currentFrame = ((ticks - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
 			sprite.srcRect.x = animation.currentFrame * sprite.width;
-		}
+		};
+		threadPool.ParallelFor(view.GetSize(), chunkSize, [&view, &animate](int begin, int end) {
+			view.Each(animate, begin, end);
+		});
 	}
 };
@@ -9,6 +9,7 @@ public:
 	CameraMovementSystem() {
 		RequireComponent<CameraFollowComponent>();
 		RequireComponent<TransformComponent>();
+		ReadsComponent<TransformComponent>();
 	}
 
 	void Update(SDL_Rect& camera) {
@@ -2,61 +2,79 @@
 #include "../ECS/ECS.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/SpriteComponent.h"
+#include "../Components/HealthComponent.h"
+#include "../Components/AudioComponent.h"
+#include "../Components/ProjectileComponent.h"
 #include "../Logger/Logger.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/CollisionEvent.h"
+#include "../Physics/ColliderBounds.h"
+#include "../Physics/SpatialHash.h"
+#include "../Physics/Narrowphase.h"
+#include <vector>
 
 class CollisionSystem : public System {
+private:
+	// The largest scene where FindOverlaps with SSE2, the path of the x64 builds, is still faster than
+	// the spatial hash in the narrowphase benchmark of the Benchmarks project. It is 192 with AVX2 and
+	// 64 when testing the pairs one at a time.
+	static const int MAX_COLLIDERS_WITHOUT_BROADPHASE = 128;
+
+	// Kept between frames, so the collision tests do not allocate once they have grown
+	SpatialHash spatialHash;
+	ColliderBounds bounds;
+	std::vector<std::pair<int, int>> candidatePairs;
+	std::vector<std::pair<int, int>> collidingPairs;
+
 public:
-	CollisionSystem() {
+	// The cell size of the broadphase should be about the size of the common colliders
+	CollisionSystem(double cellSize = 64.0) : spatialHash(cellSize) {
 		RequireComponent<TransformComponent>();
 		RequireComponent<BoxColliderComponent>();
+		ReadsComponent<TransformComponent>();
+		ReadsComponent<BoxColliderComponent>();
+
+		// The collision event handlers of the DamageSystem and MovementSystem run inside this update
+		ReadsComponent<ProjectileComponent>();
+		WritesComponent<HealthComponent>();
+		WritesComponent<AudioComponent>();
+		WritesComponent<RigidBodyComponent>();
+		WritesComponent<SpriteComponent>();
 	}
 	
 	void Update(std::unique_ptr<EventBus>& eventBus) {
-		// Check all the entities that have box collider to see if they collide
-		auto entities = GetSystemEntities();
-		for (auto i = entities.begin(); i != entities.end(); i++) {
-			Entity a = *i;
-			auto aTransform = a.GetComponent<TransformComponent>();
-			auto aCollider = a.GetComponent<BoxColliderComponent>();
-
-			for (auto j = i; j != entities.end(); j++) {
-				Entity b = *j;
-
-				if (a == b) {
-					continue;
-				}
-
-				auto& bTransform = b.GetComponent<TransformComponent>();
-				auto& bCollider = b.GetComponent<BoxColliderComponent>();
+		// Gather the bounds of all the entities that have box collider
+		const auto& entities = GetSystemEntities();
+		const int numEntities = static_cast<int>(entities.size());
+		bounds.Clear();
+		bounds.Reserve(numEntities);
+		for (auto entity : entities) {
+			const auto& transform = entity.GetComponent<TransformComponent>();
+			const auto& collider = entity.GetComponent<BoxColliderComponent>();
+			const float x = transform.position.x + collider.offset.x;
+			const float y = transform.position.y + collider.offset.y;
+			bounds.Add(x, y, x + collider.width, y + collider.height, collider.layer, collider.collidesWith);
+		}
 
-				bool collisionHappened = CheckAABBCollision(
-					aTransform.position.x + aCollider.offset.x,
-					aTransform.position.y + aCollider.offset.y,
-					aCollider.width,
-					aCollider.height,
-					bTransform.position.x + bCollider.offset.x,
-					bTransform.position.y + bCollider.offset.y,
-					bCollider.width,
-					bCollider.height
-				);
+		// A few colliders are faster to test all together than to sort in the broadphase, else only
+		// the entities that share a cell of the broadphase are tested. The pairs come sorted either
+		// way, so the events are emitted in the same order as when every pair was checked.
+		if (numEntities <= MAX_COLLIDERS_WITHOUT_BROADPHASE) {
+			Narrowphase::FindOverlaps(bounds, collidingPairs);
+		}
+		else {
+			spatialHash.FindPairs(bounds, candidatePairs);
+			Narrowphase::FilterOverlaps(bounds, candidatePairs, collidingPairs);
+		}
 
-				if (collisionHappened) {
-					Logger::Log("Entity " + std::to_string(a.GetId()) + " is colliding with entity " + std::to_string(b.GetId()));
+		for (auto& collidingPair : collidingPairs) {
+			Entity a = entities[collidingPair.first];
+			Entity b = entities[collidingPair.second];
+			Logger::Debug("Entity ", a.GetId(), " is colliding with entity ", b.GetId());
 
-					eventBus->EmitEvent<CollisionEvent>(a, b);
-				}
-			}
+			eventBus->EmitEvent<CollisionEvent>(a, b);
 		}
 	}
-
-	bool CheckAABBCollision(double aX, double aY, double aW, double aH, double bX, double bY, double bW, double bH) {
-		return (
-			aX < bX + bW &&
-			aX + aW > bX &&
-			aY < bY + bH &&
-			aY + aH > bY
-		);
-	}
 };
\ No newline at end of file
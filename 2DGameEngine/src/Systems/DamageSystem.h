@@ -7,9 +7,13 @@
 #include "../EventBus/EventBus.h"
 #include "../Events/CollisionEvent.h"
 #include "../Logger/Logger.h"
-#include <SDL_mixer.h>
 
 class DamageSystem : public System {
+private:
+	const int playerTag = Registry::GetTagId("player");
+	const int projectilesGroup = Registry::GetGroupId("projectiles");
+	const int enemiesGroup = Registry::GetGroupId("enemies");
+
 public:
 	DamageSystem() {
 		RequireComponent<BoxColliderComponent>();
@@ -22,21 +26,21 @@ public:
 	void OnCollision(CollisionEvent& event) {
 		Entity a = event.a;
 		Entity b = event.b;
-		Logger::Log("Collision event emitted " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
+		Logger::Debug("Collision event emitted ", a.GetId(), " and ", b.GetId());
 		
-		if (a.BelongsToGroup("projectiles") && b.HasTag("player")) {
+		if (a.BelongsToGroup(projectilesGroup) && b.HasTag(playerTag)) {
 			OnProjectileHitsPlayer(a, b);
 		}
 
-		if (b.BelongsToGroup("projectiles") && a.HasTag("player")) {
+		if (b.BelongsToGroup(projectilesGroup) && a.HasTag(playerTag)) {
 			OnProjectileHitsPlayer(b, a);
 		}
 
-		if (a.BelongsToGroup("projectiles") && b.BelongsToGroup("enemies")) {
+		if (a.BelongsToGroup(projectilesGroup) && b.BelongsToGroup(enemiesGroup)) {
 			OnProjectileHitsEnemy(a, b);
 		}
 
-		if (b.BelongsToGroup("projectiles") && a.BelongsToGroup("enemies")) {
+		if (b.BelongsToGroup(projectilesGroup) && a.BelongsToGroup(enemiesGroup)) {
 			OnProjectileHitsEnemy(b, a);
 		}
 	}
@@ -51,10 +55,9 @@ public:
 
 			if (health.healthPercentage <= 0) {
 				if (player.HasComponent<AudioComponent>()) {
-					auto& audio = player.GetComponent<AudioComponent>();
-					// Stop the audio immediately
-					Mix_HaltChannel(audio.channel);
-					audio.channel = Game::DEFAULT_CHANNEL;
+					// The collision handlers run on a worker thread, so the SDL mixer call is left to the
+					// PlayAudioSystem, later in the same frame, before the kill is applied
+					player.GetComponent<AudioComponent>().isHaltRequested = true;
 				}
 				player.Kill();
 			}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../ECS/ECS.h"
+#include "../Scheduler/ThreadPool.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/CollisionEvent.h"
 #include "../Components/TransformComponent.h"
@@ -7,10 +8,17 @@
 #include "../Components/SpriteComponent.h"
 
 class MovementSystem : public System {
+private:
+	const int playerTag = Registry::GetTagId("player");
+	const int enemiesGroup = Registry::GetGroupId("enemies");
+	const int obstaclesGroup = Registry::GetGroupId("obstacles");
+
 public:
 	MovementSystem() {
 		RequireComponent<TransformComponent>();
 		RequireComponent<RigidBodyComponent>();
+		ReadsComponent<RigidBodyComponent>();
+		WritesComponent<TransformComponent>();
 	}
 
 	void SubscribeToEvents(const std::unique_ptr<EventBus>& eventBus) {
@@ -20,13 +28,13 @@ public:
 	void OnCollision(CollisionEvent& event) {
 		Entity a = event.a;
 		Entity b = event.b;
-		Logger::Log("Collision event emitted " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
+		Logger::Debug("Collision event emitted ", a.GetId(), " and ", b.GetId());
 
-		if (a.BelongsToGroup("enemies") && b.BelongsToGroup("obstacles")) {
+		if (a.BelongsToGroup(enemiesGroup) && b.BelongsToGroup(obstaclesGroup)) {
 			OnProjectileHitsObstacle(a, b);
 		}
 
-		if (b.BelongsToGroup("enemies") && a.BelongsToGroup("obstacles")) {
+		if (b.BelongsToGroup(enemiesGroup) && a.BelongsToGroup(obstaclesGroup)) {
 			OnProjectileHitsObstacle(b, a);
 		}
 	}
@@ -48,19 +56,18 @@ public:
 		}
 	}
 
-	void Update(double deltaTime) {
-		// Loop all the entities that the system is interested in
-		for (auto entity : GetSystemEntities()) {
-			// Update entity position based on its velocity
-			auto& transform = entity.GetComponent<TransformComponent>();
-			const auto rigidbody = entity.GetComponent<RigidBodyComponent>();
-
+	void Update(std::unique_ptr<Registry>& registry, ThreadPool& threadPool, double deltaTime) {
+		// Every entity only touches its own components, so the packed Transform/RigidBody range is
+		// split in chunks that the workers update independently
+		const int chunkSize = 1024;
+		auto view = registry->View<TransformComponent, RigidBodyComponent>();
+		auto move = [this, deltaTime](Entity entity, TransformComponent& transform, const RigidBodyComponent& rigidbody) {
 			// Update the entity position based on its velocity
 			transform.position.x += rigidbody.velocity.x * deltaTime;
 			transform.position.y += rigidbody.velocity.y * deltaTime;
 
 			// Prevent the main player from moving outside the map boundaries
-			if (entity.HasTag("player")) {
+			if (entity.HasTag(playerTag)) {
 				int paddingLeft = 10;
 				int paddingTop = 10;
 				int paddingRight = 50;
@@ -78,9 +85,12 @@ public:
 				transform.position.y > Game::mapHeight
 			);
 
-			if (isEntityOutsideMap && !entity.HasTag("player")) {
+			if (isEntityOutsideMap && !entity.HasTag(playerTag)) {
 				entity.Kill();
 			}
-		}
+		};
+		threadPool.ParallelFor(view.GetSize(), chunkSize, [&view, &move](int begin, int end) {
+			view.Each(move, begin, end);
+		});
 	}
 };
@@ -7,12 +7,21 @@ class PlayAudioSystem : public System {
 public:
 	PlayAudioSystem() {
 		RequireComponent<AudioComponent>();
+
+		// Keep the SDL mixer calls on the main thread
+		SetExclusive(true);
 	}
 
 	void Update(const std::unique_ptr<AssetStore>& assetStore) {
 		for (auto& entity : GetSystemEntities()) {
 			auto& audio = entity.GetComponent<AudioComponent>();
 
+			if (audio.isHaltRequested) {
+				Mix_HaltChannel(audio.channel);
+				audio.channel = Game::DEFAULT_CHANNEL;
+				audio.isHaltRequested = false;
+			}
+
 			if (audio.channel == Game::DEFAULT_CHANNEL) {
 				continue;
 			}
@@ -1,6 +1,8 @@
 #pragma once
 #include <SDL.h>
 #include "../ECS/ECS.h"
+#include "../ECS/CommandBuffer.h"
+#include "../ECS/Prefab.h"
 #include "../Events/KeyPressedEvent.h"
 #include "../EventBus/EventBus.h"
 #include "../Components/TransformComponent.h"
@@ -11,10 +13,20 @@
 #include "../Components/ProjectileComponent.h"
 
 class ProjectileEmitSystem : public System {
+private:
+	// Projectiles are spawned through a command buffer, so the system can run on a worker thread
+	CommandBuffer& commandBuffer;
+
+	// Sprite, collider and group shared by every projectile
+	const Prefab& projectilePrefab;
+
 public:
-	ProjectileEmitSystem() {
+	ProjectileEmitSystem(CommandBuffer& commandBuffer, const Prefab& projectilePrefab) : commandBuffer(commandBuffer), projectilePrefab(projectilePrefab) {
 		RequireComponent<TransformComponent>();
 		RequireComponent<ProjectileEmitterComponent>();
+		ReadsComponent<TransformComponent>();
+		ReadsComponent<SpriteComponent>();
+		WritesComponent<ProjectileEmitterComponent>();
 	}
 
 	void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
@@ -50,19 +62,16 @@ public:
 					projectileVelocity.x = projectileEmitter.projectileVelocity.x * directionX;
 					projectileVelocity.y = projectileEmitter.projectileVelocity.y * directionY;
 
-					Entity projectile = entity.registry->CreateEntity();
-					projectile.Group("projectiles");
-					projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-					projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
-					projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-					projectile.AddComponent<BoxColliderComponent>(4, 4);
-					projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
+					PendingEntity projectile = commandBuffer.Instantiate(projectilePrefab);
+					commandBuffer.AddComponent<TransformComponent>(projectile, projectilePosition, glm::vec2(1.0, 1.0), 0.0);
+					commandBuffer.AddComponent<RigidBodyComponent>(projectile, projectileVelocity);
+					commandBuffer.AddComponent<ProjectileComponent>(projectile, projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
 				}
 			}
 		}
 	}
 
-	void Update(std::unique_ptr<Registry>& registry) {
+	void Update() {
 		for (auto entity : GetSystemEntities()) {
 			auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
 			const auto transform = entity.GetComponent<TransformComponent>();
@@ -80,13 +89,10 @@ public:
 					projectilePosition.y += (transform.scale.y * sprite.height / 2);
 				}
 
-				Entity projectile = registry->CreateEntity();
-				projectile.Group("projectiles");
-				projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-				projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
-				projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-				projectile.AddComponent<BoxColliderComponent>(4, 4);
-				projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
+				PendingEntity projectile = commandBuffer.Instantiate(projectilePrefab);
+				commandBuffer.AddComponent<TransformComponent>(projectile, projectilePosition, glm::vec2(1.0, 1.0), 0.0);
+				commandBuffer.AddComponent<RigidBodyComponent>(projectile, projectileEmitter.projectileVelocity);
+				commandBuffer.AddComponent<ProjectileComponent>(projectile, projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
 
 				projectileEmitter.lastEmissionTime = SDL_GetTicks();
 			}
@@ -7,6 +7,7 @@ class ProjectileLifecycleSystem : public System {
 public:
 	ProjectileLifecycleSystem() {
 		RequireComponent<ProjectileComponent>();
+		ReadsComponent<ProjectileComponent>();
 	}
 
 	void Update() {
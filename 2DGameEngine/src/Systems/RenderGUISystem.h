@@ -74,22 +74,41 @@ public:
 
 			if (ImGui::Button("Spawn new enemy")) {
 				Entity enemy = registry->CreateEntity();
-				enemy.Group("enemies");
-				enemy.AddComponent<TransformComponent>(glm::vec2(posX, posY), glm::vec2(scaleX, scaleY), glm::degrees(rotation));
-				enemy.AddComponent<RigidBodyComponent>(glm::vec2(velX, velY));
-				enemy.AddComponent<SpriteComponent>(sprites[selectedSpriteIndex], 32, 32, 1);
-				enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5));
-				double projVelX = cos(projAngle) * projSpeed; // convert from angle-speed to x-value
-				double projVelY = sin(projAngle) * projSpeed; // convert from angle-speed to y-value
-				enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projVelX, projVelY), projRepeat * 1000, projDuration * 1000, 10, false);
-				enemy.AddComponent<HealthComponent>(health);
+				if (enemy.IsValid()) {
+					enemy.Group("enemies");
+					enemy.AddComponent<TransformComponent>(glm::vec2(posX, posY), glm::vec2(scaleX, scaleY), glm::degrees(rotation));
+					enemy.AddComponent<RigidBodyComponent>(glm::vec2(velX, velY));
+					enemy.AddComponent<SpriteComponent>(sprites[selectedSpriteIndex], 32, 32, 1);
+					enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5), COLLISION_LAYER_ENEMIES, COLLISION_LAYER_PROJECTILES | COLLISION_LAYER_OBSTACLES);
+					double projVelX = cos(projAngle) * projSpeed; // convert from angle-speed to x-value
+					double projVelY = sin(projAngle) * projSpeed; // convert from angle-speed to y-value
+					enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projVelX, projVelY), projRepeat * 1000, projDuration * 1000, 10, false);
+					enemy.AddComponent<HealthComponent>(health);
 			
-				// Reset all input values after we created a new enemy
-				posX = posY = rotation = projAngle = 0;
-				scaleX = scaleY = 1;
-				projRepeat = projDuration = 10;
-				projSpeed = 100;
-				health = 100;
+					// Reset all input values after we created a new enemy
+					posX = posY = rotation = projAngle = 0;
+					scaleX = scaleY = 1;
+					projRepeat = projDuration = 10;
+					projSpeed = 100;
+					health = 100;
+				}
+			}
+		}
+		ImGui::End();
+
+		// Display the size and memory of the component pools
+		if (ImGui::Begin("Component pools")) {
+			size_t usedBytes = 0;
+			size_t reservedBytes = 0;
+			for (auto& stats : registry->GetPoolStats()) {
+				ImGui::Text("%s: %d/%d (%zu/%zu bytes)", stats.componentName, stats.size, stats.capacity, stats.usedBytes, stats.reservedBytes);
+				usedBytes += stats.usedBytes;
+				reservedBytes += stats.reservedBytes;
+			}
+			ImGui::Separator();
+			ImGui::Text("Total: %zu/%zu bytes, %zu bytes held by the arena", usedBytes, reservedBytes, registry->GetMemoryArena().GetReservedBytes());
+			if (ImGui::Button("Trim pools")) {
+				registry->TrimPools();
 			}
 		}
 		ImGui::End();
@@ -7,6 +7,9 @@
 #include <SDL.h>
 
 class RenderHealthBarSystem : public System {
+private:
+    FontHandle healthFont = "pico8-font-5";
+
 public:
     RenderHealthBarSystem() {
         RequireComponent<TransformComponent>();
@@ -14,12 +17,8 @@ public:
         RequireComponent<HealthComponent>();
     }
 
-    void Update(SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) {
-        for (auto entity : GetSystemEntities()) {
-            const auto& transform = entity.GetComponent<TransformComponent>();
-            const auto& sprite = entity.GetComponent<SpriteComponent>();
-            const auto& health = entity.GetComponent<HealthComponent>();
-
+    void Update(std::unique_ptr<Registry>& registry, SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) {
+        registry->View<HealthComponent, TransformComponent, SpriteComponent>().Each([&](Entity, const HealthComponent& health, const TransformComponent& transform, const SpriteComponent& sprite) {
             // Draw a the health bar with the correct color for the percentage
             SDL_Color healthBarColor = { 255, 255, 255 };
 
@@ -53,7 +52,7 @@ public:
 
             // Render the health percentage text label indicator
             std::string healthText = std::to_string(health.healthPercentage);
-            SDL_Surface* surface = TTF_RenderText_Blended(assetStore->GetFont("pico8-font-5"), healthText.c_str(), healthBarColor);
+            SDL_Surface* surface = TTF_RenderText_Blended(assetStore->GetFont(healthFont), healthText.c_str(), healthBarColor);
             SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
             SDL_FreeSurface(surface);
 
@@ -70,6 +69,6 @@ public:
             SDL_RenderCopy(renderer, texture, NULL, &healthBarTextRectangle);
 
             SDL_DestroyTexture(texture);
-        }
+        });
     }
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Scheduler/ThreadPool.h"
 #include <SDL.h>
 #include <vector>
 #include <algorithm>
@@ -14,7 +15,7 @@ public:
         RequireComponent<SpriteComponent>();
     }
 
-    void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera) {
+    void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera, ThreadPool& threadPool) {
         // Create a helper struct
         struct RenderableEntity {
             TransformComponent transformComponent;
@@ -25,27 +26,40 @@ public:
             }
         };
 
-        std::vector<RenderableEntity> renderableEntities;
+        // Cull the entities in parallel chunks, each chunk collecting its visible entities separately
+        const auto& entities = GetSystemEntities();
+        const int numEntities = static_cast<int>(entities.size());
+        const int chunkSize = 1024;
+        std::vector<std::vector<RenderableEntity>> renderableChunks((numEntities + chunkSize - 1) / chunkSize);
 
-        for (auto entity : GetSystemEntities()) {
-            RenderableEntity renderableEntity;
-            renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
-            renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
+        threadPool.ParallelFor(numEntities, chunkSize, [&](int begin, int end) {
+            auto& renderableChunk = renderableChunks[begin / chunkSize];
+            for (int i = begin; i < end; i++) {
+                Entity entity = entities[i];
+                const auto& transform = entity.GetComponent<TransformComponent>();
+                const auto& sprite = entity.GetComponent<SpriteComponent>();
 
-            // Check if the entity sprite is outside the camera view
-            bool isEntityOutsideCameraView = (
-                renderableEntity.transformComponent.position.x + (renderableEntity.transformComponent.scale.x * renderableEntity.spriteComponent.width) < camera.x ||
-                renderableEntity.transformComponent.position.x > camera.x + camera.w ||
-                renderableEntity.transformComponent.position.y + (renderableEntity.transformComponent.scale.y * renderableEntity.spriteComponent.height) < camera.y ||
-                renderableEntity.transformComponent.position.y > camera.y + camera.h
-            );
-            
-            // Cull sprites that are outside the camera view (and are not fixed)
-            if (isEntityOutsideCameraView && !renderableEntity.spriteComponent.isFixed) {
-                continue;
+                // Check if the entity sprite is outside the camera view
+                bool isEntityOutsideCameraView = (
+                    transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                    transform.position.x > camera.x + camera.w ||
+                    transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+                    transform.position.y > camera.y + camera.h
+                );
+
+                // Cull sprites that are outside the camera view (and are not fixed)
+                if (isEntityOutsideCameraView && !sprite.isFixed) {
+                    continue;
+                }
+
+                renderableChunk.push_back({ transform, sprite });
             }
+        });
 
-            renderableEntities.emplace_back(renderableEntity);
+        // Concatenate the chunks in order, so the draw order does not depend on the thread count
+        std::vector<RenderableEntity> renderableEntities;
+        for (auto& renderableChunk : renderableChunks) {
+            renderableEntities.insert(renderableEntities.end(), std::make_move_iterator(renderableChunk.begin()), std::make_move_iterator(renderableChunk.end()));
         }
         
         // Sort all the entities by the z-index
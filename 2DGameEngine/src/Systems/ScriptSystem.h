@@ -1,5 +1,6 @@
 #pragma once
 #include "../ECS/ECS.h"
+#include "../ECS/Prefab.h"
 #include "../Components/ScriptComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/RigidBodyComponent.h"
@@ -86,16 +87,20 @@ class ScriptSystem : public System {
 public:
     ScriptSystem() {
         RequireComponent<ScriptComponent>();
+
+        // The Lua state can only be used by one thread, and scripts can touch any component
+        SetExclusive(true);
     }
 
-    void CreateLuaBindings(sol::state& lua) {
+    void CreateLuaBindings(sol::state& lua, Registry& registry) {
         // Create the "entity" usertype so Lua knows what an entity is
         lua.new_usertype<Entity>(
             "entity",
             "get_id", &Entity::GetId,
+            "is_alive", &Entity::IsAlive,
             "destroy", &Entity::Kill,
-            "has_tag", &Entity::HasTag,
-            "belongs_to_group", &Entity::BelongsToGroup
+            "has_tag", sol::resolve<bool(const std::string&) const>(&Entity::HasTag),
+            "belongs_to_group", sol::resolve<bool(const std::string&) const>(&Entity::BelongsToGroup)
         );
 
         // Create all the bindings between C++ and Lua functions
@@ -106,6 +111,20 @@ public:
         lua.set_function("set_rotation", SetEntityRotation);
         lua.set_function("set_projectile_velocity", SetProjectileVelocity);
         lua.set_function("set_animation_frame", SetEntityAnimationFrame);
+
+        // Returns nil if there is no prefab with that name
+        lua.set_function("instantiate_prefab", [&registry](const std::string& name) -> sol::optional<Entity> {
+            const Prefab* prefab = registry.GetPrefab(name);
+            if (!prefab) {
+                Logger::Err("Trying to instantiate an unknown prefab: " + name);
+                return sol::nullopt;
+            }
+            Entity entity = registry.Instantiate(*prefab);
+            if (!entity.IsValid()) {
+                return sol::nullopt;
+            }
+            return entity;
+        });
     }
 
     void Update(double deltaTime, int ellapsedTime) {
@@ -0,0 +1,370 @@
+#include "TileLayer.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+// Limit of the map size, so the chunk indices of a tilemap file fit in an int (the tile
+// indices do not, see GetTileIndex)
+static const int MAX_MAP_SIZE = 1 << 20;
+
+void TileLayer::SetSize(int numRows, int numCols, int tileSize, double scale, TextureHandle texture) {
+    this->numRows = numRows;
+    this->numCols = numCols;
+    this->tileSize = tileSize;
+    this->scale = scale;
+    this->texture = texture;
+
+    // The last chunks of a row or a column are only partly used, and keep empty tiles
+    numChunkRows = (numRows + CHUNK_MASK) >> CHUNK_SHIFT;
+    numChunkCols = (numCols + CHUNK_MASK) >> CHUNK_SHIFT;
+}
+
+const uint16_t* TileLayer::GetTiles() const {
+    if (tilemapFile.GetData()) {
+        return reinterpret_cast<const uint16_t*>(tilemapFile.GetData() + TILEMAP_DATA_OFFSET);
+    }
+    return tiles.data();
+}
+
+void TileLayer::Create(int numRows, int numCols, int tileSize, double scale, TextureHandle texture) {
+    Clear();
+    SetSize(numRows, numCols, tileSize, scale, texture);
+    tiles.assign(static_cast<size_t>(numChunkRows) * numChunkCols * CHUNK_SIZE * CHUNK_SIZE, EMPTY_TILE);
+}
+
+void TileLayer::Clear() {
+    numRows = 0;
+    numCols = 0;
+    numChunkRows = 0;
+    numChunkCols = 0;
+    tiles.clear();
+    tiles.shrink_to_fit();
+    tilemapFile.Close();
+    tilemapFilePath.clear();
+    residentChunks = { 0, 0, 0, 0 };
+}
+
+bool TileLayer::LoadMapFile(const std::string& mapFilePath, int tileSize, double scale, TextureHandle texture, int tilesetNumCols) {
+    std::ifstream mapFile(mapFilePath, std::ios::binary);
+    if (!mapFile) {
+        Logger::Err("Cannot open map file ", mapFilePath);
+        return false;
+    }
+    if (tilesetNumCols <= 0 || tilesetNumCols > 0xFF) {
+        Logger::Err("Invalid number of tileset columns for map file ", mapFilePath);
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(mapFile)), std::istreambuf_iterator<char>());
+
+    // Parse the cells row by row, the rows can have any number of digits and of cells
+    std::vector<uint16_t> cells;
+    std::vector<int> rowStarts;
+    int cell = -1;
+    bool isRowStarted = false;
+    auto endCell = [&]() {
+        if (!isRowStarted) {
+            rowStarts.push_back(static_cast<int>(cells.size()));
+            isRowStarted = true;
+        }
+        cells.push_back(cell == -1 ? EMPTY_TILE : MakeTile(cell / tilesetNumCols, cell % tilesetNumCols));
+        cell = -1;
+    };
+    for (char ch : text) {
+        if (ch >= '0' && ch <= '9') {
+            cell = (cell == -1 ? 0 : cell * 10) + (ch - '0');
+            if (cell / tilesetNumCols >= 0xFF) {
+                Logger::Err("Tile index out of the tileset in map file ", mapFilePath);
+                return false;
+            }
+        }
+        else if (ch == ',') {
+            endCell();
+        }
+        else if (ch == '\n') {
+            if (cell != -1) {
+                endCell();
+            }
+            isRowStarted = false;
+        }
+        else if (ch != '\r' && ch != ' ' && ch != '\t') {
+            Logger::Err("Unexpected character '", ch, "' in map file ", mapFilePath);
+            return false;
+        }
+    }
+    if (cell != -1) {
+        endCell();
+    }
+
+    const int mapNumRows = static_cast<int>(rowStarts.size());
+    int mapNumCols = 0;
+    for (int y = 0; y < mapNumRows; y++) {
+        const int rowEnd = y + 1 < mapNumRows ? rowStarts[y + 1] : static_cast<int>(cells.size());
+        mapNumCols = std::max(mapNumCols, rowEnd - rowStarts[y]);
+    }
+    if (mapNumRows > MAX_MAP_SIZE || mapNumCols > MAX_MAP_SIZE) {
+        Logger::Err("Map file ", mapFilePath, " is too big");
+        return false;
+    }
+
+    // Shorter rows are padded with empty tiles
+    Create(mapNumRows, mapNumCols, tileSize, scale, texture);
+    for (int y = 0; y < mapNumRows; y++) {
+        const int rowEnd = y + 1 < mapNumRows ? rowStarts[y + 1] : static_cast<int>(cells.size());
+        for (int x = 0; x < rowEnd - rowStarts[y]; x++) {
+            tiles[GetTileIndex(y, x)] = cells[rowStarts[y] + x];
+        }
+    }
+    return true;
+}
+
+bool TileLayer::OpenTilemapFile(const std::string& tilemapFilePath, int tileSize, double scale, TextureHandle texture, int residencyRadius) {
+    Clear();
+    if (!tilemapFile.Open(tilemapFilePath)) {
+        return false;
+    }
+
+    SnapshotReader reader(tilemapFile.GetData(), tilemapFile.GetSize());
+    uint32_t magic;
+    uint32_t version;
+    int32_t fileNumRows;
+    int32_t fileNumCols;
+    int32_t chunkShift;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != TILEMAP_MAGIC || version != TILEMAP_VERSION) {
+        Logger::Err("File ", tilemapFilePath, " is not a tilemap of this version");
+        Clear();
+        return false;
+    }
+    if (!reader.Read(fileNumRows) || !reader.Read(fileNumCols) || !reader.Read(chunkShift) ||
+        fileNumRows < 0 || fileNumRows > MAX_MAP_SIZE || fileNumCols < 0 || fileNumCols > MAX_MAP_SIZE || chunkShift != CHUNK_SHIFT) {
+        Logger::Err("Invalid header in tilemap file ", tilemapFilePath);
+        Clear();
+        return false;
+    }
+
+    SetSize(fileNumRows, fileNumCols, tileSize, scale, texture);
+    const size_t tilemapSize = TILEMAP_DATA_OFFSET + static_cast<size_t>(numChunkRows) * numChunkCols * CHUNK_BYTES;
+    if (tilemapFile.GetSize() < tilemapSize) {
+        Logger::Err("Tilemap file ", tilemapFilePath, " is truncated");
+        Clear();
+        return false;
+    }
+    this->tilemapFilePath = tilemapFilePath;
+    this->residencyRadius = std::max(0, residencyRadius);
+    return true;
+}
+
+bool TileLayer::SaveTilemapFile(const std::string& tilemapFilePath) const {
+    SnapshotWriter writer;
+    const size_t numTiles = static_cast<size_t>(numChunkRows) * numChunkCols * CHUNK_SIZE * CHUNK_SIZE;
+    writer.Reserve(TILEMAP_DATA_OFFSET + numTiles * sizeof(uint16_t));
+    writer.Write(TILEMAP_MAGIC);
+    writer.Write(TILEMAP_VERSION);
+    writer.Write(static_cast<int32_t>(numRows));
+    writer.Write(static_cast<int32_t>(numCols));
+    writer.Write(static_cast<int32_t>(CHUNK_SHIFT));
+    const std::vector<char> padding(TILEMAP_DATA_OFFSET - writer.GetBuffer().size(), 0);
+    writer.WriteBytes(padding.data(), padding.size());
+    writer.WriteArray(GetTiles(), numTiles);
+    return writer.SaveToFile(tilemapFilePath);
+}
+
+bool TileLayer::ConvertMapFile(const std::string& mapFilePath, const std::string& tilemapFilePath, int tilesetNumCols) {
+    TileLayer tileLayer;
+    if (!tileLayer.LoadMapFile(mapFilePath, 0, 1.0, TextureHandle(), tilesetNumCols) || !tileLayer.SaveTilemapFile(tilemapFilePath)) {
+        return false;
+    }
+    Logger::Log("Map file ", mapFilePath, " converted to ", tilemapFilePath, " (", tileLayer.GetNumRows(), "x", tileLayer.GetNumCols(), " tiles)");
+    return true;
+}
+
+std::string TileLayer::GetTilemapFilePath(const std::string& mapFilePath) {
+    const size_t extension = mapFilePath.find_last_of('.');
+    const size_t directory = mapFilePath.find_last_of("/\\");
+    if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) {
+        return mapFilePath + ".tilemap";
+    }
+    return mapFilePath.substr(0, extension) + ".tilemap";
+}
+
+bool TileLayer::IsEmpty() const {
+    return numRows == 0 || numCols == 0;
+}
+
+bool TileLayer::IsStreamed() const {
+    return tilemapFile.IsOpen();
+}
+
+int TileLayer::GetNumRows() const {
+    return numRows;
+}
+
+int TileLayer::GetNumCols() const {
+    return numCols;
+}
+
+int TileLayer::GetWidth() const {
+    return static_cast<int>(numCols * tileSize * scale);
+}
+
+int TileLayer::GetHeight() const {
+    return static_cast<int>(numRows * tileSize * scale);
+}
+
+uint16_t TileLayer::GetTile(int row, int col) const {
+    if (row < 0 || row >= numRows || col < 0 || col >= numCols) {
+        return EMPTY_TILE;
+    }
+    return GetTiles()[GetTileIndex(row, col)];
+}
+
+void TileLayer::SetTile(int row, int col, uint16_t tile) {
+    if (row < 0 || row >= numRows || col < 0 || col >= numCols) {
+        Logger::Err("Tile (", row, ", ", col, ") is outside the tile layer");
+        return;
+    }
+    if (IsStreamed()) {
+        Logger::Err("Tiles of the streamed tilemap ", tilemapFilePath, " cannot be changed");
+        return;
+    }
+    tiles[GetTileIndex(row, col)] = tile;
+}
+
+void TileLayer::GetVisibleRange(const SDL_Rect& camera, int& firstRow, int& lastRow, int& firstCol, int& lastCol) const {
+    const double scaledTileSize = tileSize * scale;
+    firstRow = std::max(0, static_cast<int>(std::floor(camera.y / scaledTileSize)));
+    lastRow = std::min(numRows - 1, static_cast<int>(std::floor((camera.y + camera.h) / scaledTileSize)));
+    firstCol = std::max(0, static_cast<int>(std::floor(camera.x / scaledTileSize)));
+    lastCol = std::min(numCols - 1, static_cast<int>(std::floor((camera.x + camera.w) / scaledTileSize)));
+}
+
+void TileLayer::UpdateResidency(const SDL_Rect& camera) {
+    if (!IsStreamed() || IsEmpty()) {
+        return;
+    }
+
+    int firstRow, lastRow, firstCol, lastCol;
+    GetVisibleRange(camera, firstRow, lastRow, firstCol, lastCol);
+    SDL_Rect chunks = { 0, 0, 0, 0 };
+    if (firstRow <= lastRow && firstCol <= lastCol) {
+        const int firstChunkCol = std::max(0, (firstCol >> CHUNK_SHIFT) - residencyRadius);
+        const int lastChunkCol = std::min(numChunkCols - 1, (lastCol >> CHUNK_SHIFT) + residencyRadius);
+        const int firstChunkRow = std::max(0, (firstRow >> CHUNK_SHIFT) - residencyRadius);
+        const int lastChunkRow = std::min(numChunkRows - 1, (lastRow >> CHUNK_SHIFT) + residencyRadius);
+        chunks = { firstChunkCol, firstChunkRow, lastChunkCol - firstChunkCol + 1, lastChunkRow - firstChunkRow + 1 };
+    }
+    if (SDL_RectEquals(&chunks, &residentChunks)) {
+        return;
+    }
+
+    auto isInside = [](const SDL_Rect& rect, int chunkCol, int chunkRow) {
+        return chunkCol >= rect.x && chunkCol < rect.x + rect.w && chunkRow >= rect.y && chunkRow < rect.y + rect.h;
+    };
+    auto getChunkOffset = [this](int chunkCol, int chunkRow) {
+        return TILEMAP_DATA_OFFSET + (static_cast<size_t>(chunkRow) * numChunkCols + chunkCol) * CHUNK_BYTES;
+    };
+
+    // Chunks that left the radius go back to the OS, the ones that entered it are read ahead of the camera
+    for (int chunkRow = residentChunks.y; chunkRow < residentChunks.y + residentChunks.h; chunkRow++) {
+        for (int chunkCol = residentChunks.x; chunkCol < residentChunks.x + residentChunks.w; chunkCol++) {
+            if (!isInside(chunks, chunkCol, chunkRow)) {
+                tilemapFile.Release(getChunkOffset(chunkCol, chunkRow), CHUNK_BYTES);
+            }
+        }
+    }
+    for (int chunkRow = chunks.y; chunkRow < chunks.y + chunks.h; chunkRow++) {
+        for (int chunkCol = chunks.x; chunkCol < chunks.x + chunks.w; chunkCol++) {
+            if (!isInside(residentChunks, chunkCol, chunkRow)) {
+                tilemapFile.Prefetch(getChunkOffset(chunkCol, chunkRow), CHUNK_BYTES);
+            }
+        }
+    }
+    residentChunks = chunks;
+}
+
+void TileLayer::Render(SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) const {
+    if (IsEmpty()) {
+        return;
+    }
+
+    int firstRow, lastRow, firstCol, lastCol;
+    GetVisibleRange(camera, firstRow, lastRow, firstCol, lastCol);
+
+    const uint16_t* layerTiles = GetTiles();
+    SDL_Texture* tilesetTexture = assetStore->GetTexture(texture);
+    const double scaledTileSize = tileSize * scale;
+    const int dstSize = static_cast<int>(scaledTileSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        const int dstY = static_cast<int>(row * scaledTileSize - camera.y);
+        for (int col = firstCol; col <= lastCol; col++) {
+            const uint16_t tile = layerTiles[GetTileIndex(row, col)];
+            if (tile == EMPTY_TILE) {
+                continue;
+            }
+
+            SDL_Rect srcRect = { (tile & 0xFF) * tileSize, (tile >> 8) * tileSize, tileSize, tileSize };
+            SDL_Rect dstRect = { static_cast<int>(col * scaledTileSize - camera.x), dstY, dstSize, dstSize };
+            SDL_RenderCopy(renderer, tilesetTexture, &srcRect, &dstRect);
+        }
+    }
+}
+
+// Streamed layers only save the path of their tilemap file, the tiles stay in it
+void TileLayer::Save(SnapshotWriter& writer) const {
+    writer.Write(static_cast<uint8_t>(IsStreamed() ? 1 : 0));
+    writer.Write(static_cast<int32_t>(tileSize));
+    writer.Write(scale);
+    writer.WriteString(texture.GetName());
+    if (IsStreamed()) {
+        writer.WriteString(tilemapFilePath);
+        writer.Write(static_cast<int32_t>(residencyRadius));
+        return;
+    }
+    writer.Write(static_cast<int32_t>(numRows));
+    writer.Write(static_cast<int32_t>(numCols));
+    writer.WriteArray(tiles.data(), tiles.size());
+}
+
+bool TileLayer::Load(SnapshotReader& reader) {
+    uint8_t isStreamed;
+    int32_t savedTileSize;
+    double savedScale;
+    std::string textureName;
+    if (!reader.Read(isStreamed) || !reader.Read(savedTileSize) || !reader.Read(savedScale) || !reader.ReadString(textureName) || savedTileSize <= 0) {
+        return false;
+    }
+    const TextureHandle savedTexture = textureName.empty() ? TextureHandle() : TextureHandle(textureName);
+
+    if (isStreamed) {
+        std::string savedTilemapFilePath;
+        int32_t savedResidencyRadius;
+        if (!reader.ReadString(savedTilemapFilePath) || !reader.Read(savedResidencyRadius)) {
+            return false;
+        }
+        return OpenTilemapFile(savedTilemapFilePath, savedTileSize, savedScale, savedTexture, savedResidencyRadius);
+    }
+
+    int32_t savedNumRows;
+    int32_t savedNumCols;
+    if (!reader.Read(savedNumRows) || !reader.Read(savedNumCols)) {
+        return false;
+    }
+    if (savedNumRows < 0 || savedNumRows > MAX_MAP_SIZE || savedNumCols < 0 || savedNumCols > MAX_MAP_SIZE) {
+        return false;
+    }
+
+    // The tile count comes from the file, check it before allocating the tiles
+    const size_t numChunks = static_cast<size_t>((savedNumRows + CHUNK_MASK) >> CHUNK_SHIFT) * ((savedNumCols + CHUNK_MASK) >> CHUNK_SHIFT);
+    if (numChunks * CHUNK_BYTES > reader.GetRemainingSize()) {
+        return false;
+    }
+
+    Create(savedNumRows, savedNumCols, savedTileSize, savedScale, savedTexture);
+    if (!reader.ReadArray(tiles.data(), tiles.size())) {
+        Clear();
+        return false;
+    }
+    return true;
+}
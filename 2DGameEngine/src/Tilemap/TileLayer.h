@@ -0,0 +1,114 @@
+#pragma once
+#include "../AssetStore/AssetStore.h"
+#include "../ECS/Snapshot.h"
+#include "../FileSystem/MappedFile.h"
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Binary tilemap files start with this magic number, and the version is bumped every time the layout changes
+const uint32_t TILEMAP_MAGIC = 0x50414D54; // "TMAP"
+const uint32_t TILEMAP_VERSION = 1;
+
+// The header is padded to a page, so every chunk of a mapped tilemap file starts on a page boundary
+const size_t TILEMAP_DATA_OFFSET = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+// TileLayer
+////////////////////////////////////////////////////////////////////////////////
+// Grid of tiles drawn from a single tileset texture. Each tile is a 16-bit
+// index (the row and the column of the tile in the tileset), and the grid is
+// split into square chunks that are stored one after the other, so the tiles
+// of a screen are close together in memory. The layer does not create any
+// entity: the renderer computes the visible range of tiles from the camera
+// and only visits those, so the cost of a frame does not grow with the size
+// of the map.
+//
+// The tiles either live in memory (text .map files, compiled levels) or are
+// streamed from a memory mapped binary .tilemap file, which has the same
+// chunked layout. Streamed layers keep the chunks around the camera resident
+// and let the OS drop the other ones, so their memory use depends on the
+// view and the residency radius instead of the size of the world.
+////////////////////////////////////////////////////////////////////////////////
+class TileLayer {
+public:
+    // Chunks are CHUNK_SIZE x CHUNK_SIZE tiles, 8 KB (a whole number of pages)
+    static constexpr int CHUNK_SHIFT = 6;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr size_t CHUNK_BYTES = CHUNK_SIZE * CHUNK_SIZE * sizeof(uint16_t);
+
+    // Cells without a tile are not drawn
+    static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+    static uint16_t MakeTile(int tilesetRow, int tilesetCol) {
+        return static_cast<uint16_t>((tilesetRow << 8) | tilesetCol);
+    }
+
+private:
+    int numRows = 0;
+    int numCols = 0;
+    int numChunkRows = 0;
+    int numChunkCols = 0;
+    int tileSize = 0;
+    double scale = 1.0;
+    TextureHandle texture;
+    std::vector<uint16_t> tiles;
+
+    // Streamed layers only
+    MappedFile tilemapFile;
+    std::string tilemapFilePath;
+    int residencyRadius = 0;
+    SDL_Rect residentChunks = { 0, 0, 0, 0 };
+
+    void SetSize(int numRows, int numCols, int tileSize, double scale, TextureHandle texture);
+    const uint16_t* GetTiles() const;
+
+    // Tile indices of large maps do not fit in an int, they are computed in size_t
+    size_t GetTileIndex(int row, int col) const {
+        const size_t chunkIndex = static_cast<size_t>(row >> CHUNK_SHIFT) * numChunkCols + (col >> CHUNK_SHIFT);
+        return (chunkIndex << (2 * CHUNK_SHIFT)) + ((row & CHUNK_MASK) << CHUNK_SHIFT) + (col & CHUNK_MASK);
+    }
+
+    // Range of the tiles that overlap the camera, clamped to the map (empty when first > last)
+    void GetVisibleRange(const SDL_Rect& camera, int& firstRow, int& lastRow, int& firstCol, int& lastCol) const;
+
+public:
+    // Allocates an empty map of numRows x numCols tiles, removing the previous tiles
+    void Create(int numRows, int numCols, int tileSize, double scale, TextureHandle texture);
+    void Clear();
+
+    // Reads a text map: one line per row, and comma separated tileset indices (tilesetNumCols tiles per tileset row)
+    bool LoadMapFile(const std::string& mapFilePath, int tileSize, double scale, TextureHandle texture, int tilesetNumCols);
+
+    // Maps a binary tilemap file, the chunks are read from the file when the camera gets close to them
+    bool OpenTilemapFile(const std::string& tilemapFilePath, int tileSize, double scale, TextureHandle texture, int residencyRadius);
+    bool SaveTilemapFile(const std::string& tilemapFilePath) const;
+
+    // Offline conversion of a text map to a binary tilemap file
+    static bool ConvertMapFile(const std::string& mapFilePath, const std::string& tilemapFilePath, int tilesetNumCols);
+    static std::string GetTilemapFilePath(const std::string& mapFilePath);
+
+    bool IsEmpty() const;
+    bool IsStreamed() const;
+    int GetNumRows() const;
+    int GetNumCols() const;
+
+    // Size of the map in world units
+    int GetWidth() const;
+    int GetHeight() const;
+
+    uint16_t GetTile(int row, int col) const;
+    void SetTile(int row, int col, uint16_t tile);
+
+    // Loads the chunks within the residency radius of the camera chunks, and releases the ones that left it
+    void UpdateResidency(const SDL_Rect& camera);
+
+    // Draws the tiles the camera sees, in row order
+    void Render(SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) const;
+
+    void Save(SnapshotWriter& writer) const;
+    bool Load(SnapshotReader& reader);
+};
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/AssetStore/AssetHandle.h"
+#include <map>
+#include <string>
+
+// Textures of the first level, looked up once per sprite as the RenderSystem does
+static const char* TEXTURE_IDS[] = {
+    "chopper-texture", "su27-texture", "f22-texture", "fw190-texture",
+    "upf7-texture", "bf109-texture", "bomber-texture", "carrier-texture"
+};
+
+// Texture lookups by the string id the sprites held before, in the std::map the AssetStore used, and
+// by handle in an array indexed and bounds-checked like AssetStore::GetTexture. Stand-in textures
+// keep the benchmark free of SDL.
+bool RunAssetBenchmark() {
+    const int numTextures = sizeof(TEXTURE_IDS) / sizeof(TEXTURE_IDS[0]);
+    const int numLookups = 2000000;
+    std::printf("Asset lookup, %d lookups over %d textures, ns/lookup\n", numLookups, numTextures);
+
+    int stubTextures[numTextures] = {};
+    std::map<std::string, int*> texturesByName;
+    std::vector<int*> texturesByHandle;
+    for (int i = 0; i < numTextures; i++) {
+        stubTextures[i] = i + 1;
+        texturesByName[TEXTURE_IDS[i]] = &stubTextures[i];
+        const TextureHandle handle(TEXTURE_IDS[i]);
+        if (handle.index >= static_cast<int>(texturesByHandle.size())) {
+            texturesByHandle.resize(handle.index + 1, nullptr);
+        }
+        texturesByHandle[handle.index] = &stubTextures[i];
+    }
+
+    // The texture of every sprite, as a string id and as a handle
+    std::vector<std::string> spriteNames;
+    std::vector<TextureHandle> spriteHandles;
+    for (int id : Benchmark::ShuffledIds(numLookups)) {
+        spriteNames.push_back(TEXTURE_IDS[id % numTextures]);
+        spriteHandles.push_back(TextureHandle(TEXTURE_IDS[id % numTextures]));
+    }
+
+    uint64_t sums[2] = {};
+    const double nameNs = Benchmark::MeasureNsPerOp(numLookups, [&]() {
+        sums[0] = 0;
+        for (auto& name : spriteNames) {
+            sums[0] += *texturesByName[name];
+        }
+    });
+    const double handleNs = Benchmark::MeasureNsPerOp(numLookups, [&]() {
+        sums[1] = 0;
+        for (auto handle : spriteHandles) {
+            const int index = handle.index;
+            int* texture = index >= 0 && index < static_cast<int>(texturesByHandle.size()) ? texturesByHandle[index] : nullptr;
+            sums[1] += texture ? *texture : 0;
+        }
+    });
+
+    std::printf("  std::map<std::string> %6.1f   handle %6.1f   %s\n", nameNs, handleNs, sums[1] == sums[0] ? "same textures" : "DIFFERENT TEXTURES");
+    return sums[1] == sums[0];
+}
@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+
+// Entities with a Transform and a BoxCollider (the SDL-free stand-in for the tile Sprite), created
+// one at a time with CreateEntity/AddComponent and as a batch with CreateEntities/AddComponents. Both
+// must give the same components to the same entity ids.
+bool RunBatchBenchmark() {
+    std::printf("Batch creation, entities with a Transform and a BoxCollider, ms/batch\n");
+    std::printf("  %-8s %12s %12s\n", "", "one by one", "batched");
+    bool isSameResult = true;
+    for (int numEntities : { 500, 65536 }) {
+        std::vector<TransformComponent> transforms;
+        std::vector<BoxColliderComponent> boxColliders;
+        for (int i = 0; i < numEntities; i++) {
+            transforms.emplace_back(glm::vec2(static_cast<float>(i % 256) * 32.0f, static_cast<float>(i / 256) * 32.0f));
+            boxColliders.emplace_back(32, 32);
+        }
+
+        std::vector<int> results[2];
+        double batchNs[2] = {};
+        for (int mode = 0; mode < 2; mode++) {
+            std::unique_ptr<Registry> registry;
+            std::vector<Entity> entities;
+            batchNs[mode] = Benchmark::MeasureNsPerOp(1, [&]() {
+                registry.reset();
+                registry = std::make_unique<Registry>();
+                entities.clear();
+            }, [&]() {
+                if (mode == 0) {
+                    for (int i = 0; i < numEntities; i++) {
+                        const Entity entity = registry->CreateEntity();
+                        registry->AddComponent<TransformComponent>(entity, transforms[i]);
+                        registry->AddComponent<BoxColliderComponent>(entity, boxColliders[i]);
+                        entities.push_back(entity);
+                    }
+                    return;
+                }
+                entities = registry->CreateEntities(numEntities);
+                registry->AddComponents(entities, transforms);
+                registry->AddComponents(entities, boxColliders);
+            });
+
+            // Entity id and tile position of every entity
+            for (auto entity : entities) {
+                const auto& transform = registry->GetComponent<TransformComponent>(entity);
+                results[mode].push_back(entity.GetId());
+                results[mode].push_back(static_cast<int>(transform.position.x) + static_cast<int>(transform.position.y) * 256 + registry->GetComponent<BoxColliderComponent>(entity).width);
+            }
+            registry.reset();
+        }
+
+        std::printf("  n=%-6d %12.3f %12.3f   %s\n", numEntities, batchNs[0] / 1e6, batchNs[1] / 1e6, results[1] == results[0] ? "same components" : "DIFFERENT COMPONENTS");
+        isSameResult = isSameResult && results[1] == results[0];
+    }
+    return isSameResult;
+}
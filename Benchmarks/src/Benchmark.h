@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+////////////////////////////////////////////////////////////////////////////////
+// Minimal timing helpers shared by the engine benchmarks. Every measurement
+// runs a few times and keeps the fastest run, which is the least disturbed by
+// the rest of the machine. Build the benchmarks in Release: the Debug numbers
+// say nothing about the engine.
+////////////////////////////////////////////////////////////////////////////////
+namespace Benchmark {
+    // Number of times every measurement is repeated
+    const int NUM_RUNS = 5;
+
+    // Keeps the compiler from optimizing away a value the benchmark computes
+    inline void Consume(uint64_t value) {
+        static volatile uint64_t sink;
+        sink = sink + value;
+    }
+
+    // Runs setup() then func() NUM_RUNS times and returns the fastest func() in nanoseconds per
+    // operation. Only func() is timed.
+    template <typename TSetup, typename TFunc>
+    double MeasureNsPerOp(int numOps, TSetup&& setup, TFunc&& func) {
+        double bestNs = 0.0;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            setup();
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const auto end = std::chrono::steady_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            bestNs = run == 0 ? ns : std::min(bestNs, ns);
+        }
+        return bestNs / std::max(numOps, 1);
+    }
+
+    template <typename TFunc>
+    double MeasureNsPerOp(int numOps, TFunc&& func) {
+        return MeasureNsPerOp(numOps, []() {}, func);
+    }
+
+    // The ids 0 .. count-1 in a random order that is the same on every run
+    inline std::vector<int> ShuffledIds(int count, unsigned int seed = 42) {
+        std::vector<int> ids(count);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::shuffle(ids.begin(), ids.end(), std::mt19937(seed));
+        return ids;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "../../2DGameEngine/src/Physics/ColliderBounds.h"
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// ColliderScene
+////////////////////////////////////////////////////////////////////////////////
+// The colliders shared by the physics benchmarks, so the narrowphase and the
+// spatial hash are timed on the same scene, and the scalar all-pairs test they
+// are both compared with.
+////////////////////////////////////////////////////////////////////////////////
+namespace ColliderScene {
+    // The cell size of the CollisionSystem
+    const double CELL_SIZE = 64.0;
+
+    // Colliders of 8 to 48 units spread over a square world with one collider per 100x100 units, so
+    // the number of overlaps per collider stays the same whatever the number of colliders
+    inline ColliderBounds MakeColliders(int numColliders) {
+        std::mt19937 random(23);
+        const float worldSize = 100.0f * std::sqrt(static_cast<float>(numColliders));
+        std::uniform_real_distribution<float> position(0.0f, worldSize);
+        std::uniform_real_distribution<float> size(8.0f, 48.0f);
+        ColliderBounds bounds;
+        bounds.Reserve(numColliders);
+        for (int i = 0; i < numColliders; i++) {
+            const float x = position(random);
+            const float y = position(random);
+            bounds.Add(x, y, x + size(random), y + size(random), 1, 0xFFFFFFFF);
+        }
+        return bounds;
+    }
+
+    // The collision test before the SIMD narrowphase and the broadphase: every pair of colliders, one
+    // at a time
+    inline void FindAllPairs(const ColliderBounds& bounds, std::vector<std::pair<int, int>>& pairs) {
+        pairs.clear();
+        const int numBoxes = bounds.GetSize();
+        for (int a = 0; a < numBoxes; a++) {
+            for (int b = a + 1; b < numBoxes; b++) {
+                if (bounds.CanCollide(a, b) && bounds.Overlap(a, b)) {
+                    pairs.emplace_back(a, b);
+                }
+            }
+        }
+    }
+}
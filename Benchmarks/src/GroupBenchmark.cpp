@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+
+// Group lookup as the registry did it before the names were interned: the set of the group was
+// copied on every call
+static bool BelongsToGroupByCopy(const std::unordered_map<std::string, std::set<Entity>>& entitiesPerGroup, Entity entity, const std::string& group) {
+    if (entitiesPerGroup.find(group) == entitiesPerGroup.end()) {
+        return false;
+    }
+    auto groupEntities = entitiesPerGroup.at(group);
+    return groupEntities.find(entity) != groupEntities.end();
+}
+
+// "Is this entity a projectile?" for every entity, with half of them in the group, through the old
+// set lookup, the name overload and the id overload (the id also checks a tag, as DamageSystem does)
+bool RunGroupBenchmark() {
+    const int numEntities = 1000;
+    std::printf("Group membership, %d entities in two groups, ns/check\n", numEntities);
+
+    std::vector<int> counts(3);
+    double checkNs[3] = {};
+    Registry registry;
+    const std::vector<Entity> entities = registry.CreateEntities(numEntities);
+    std::unordered_map<std::string, std::set<Entity>> entitiesPerGroup;
+    for (int id : Benchmark::ShuffledIds(numEntities)) {
+        const std::string group = id % 2 == 0 ? "projectiles" : "enemies";
+        registry.GroupEntity(entities[id], group);
+        entitiesPerGroup[group].insert(entities[id]);
+    }
+    registry.TagEntity(entities[0], "player");
+    registry.Update();
+
+    checkNs[0] = Benchmark::MeasureNsPerOp(numEntities, [&]() {
+        counts[0] = 0;
+        for (auto entity : entities) {
+            counts[0] += BelongsToGroupByCopy(entitiesPerGroup, entity, "projectiles");
+        }
+    });
+    checkNs[1] = Benchmark::MeasureNsPerOp(numEntities, [&]() {
+        counts[1] = 0;
+        for (auto entity : entities) {
+            counts[1] += registry.EntityBelongsToGroup(entity, "projectiles");
+        }
+    });
+    const int projectilesId = Registry::GetGroupId("projectiles");
+    const int playerId = Registry::GetTagId("player");
+    checkNs[2] = Benchmark::MeasureNsPerOp(numEntities, [&]() {
+        counts[2] = 0;
+        for (auto entity : entities) {
+            counts[2] += registry.EntityBelongsToGroup(entity, projectilesId) && !registry.EntityHasTag(entity, playerId);
+        }
+    });
+
+    // entities[0] is a projectile with the player tag, so the id check counts one less
+    const bool isSameResult = counts[0] == numEntities / 2 && counts[1] == counts[0] && counts[2] == counts[0] - 1;
+    std::printf("  set copy %9.1f   name %6.1f   id and tag %6.1f   %s\n", checkNs[0], checkNs[1], checkNs[2], isSameResult ? "same members" : "DIFFERENT MEMBERS");
+    return isSameResult;
+}
@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+
+class TransformBenchmarkSystem : public System {
+public:
+    TransformBenchmarkSystem() {
+        RequireComponent<TransformComponent>();
+    }
+};
+
+class MoverBenchmarkSystem : public System {
+public:
+    MoverBenchmarkSystem() {
+        RequireComponent<TransformComponent>();
+        RequireComponent<RigidBodyComponent>();
+    }
+};
+
+// Sorted ids of the entities of a system, so the two removals can be compared
+static std::vector<int> SortedIds(const std::vector<Entity>& entities) {
+    std::vector<int> ids;
+    for (auto entity : entities) {
+        ids.push_back(entity.GetId());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// Half of the entities killed in one Update(), with every entity in two systems. The systems used to
+// erase the killed entities from their vectors one at a time, which is replayed here on plain
+// vectors of entities; the registry now swap-removes them.
+bool RunKillBenchmark() {
+    const int numEntities = 20000;
+    const int numKilled = numEntities / 2;
+    std::printf("Kill, %d of %d entities in two systems, ms/Update\n", numKilled, numEntities);
+    std::vector<int> killedIds = Benchmark::ShuffledIds(numEntities);
+    killedIds.resize(numKilled);
+
+    std::unique_ptr<Registry> registry;
+    std::vector<Entity> entities;
+    const double registryNs = Benchmark::MeasureNsPerOp(1, [&]() {
+        registry.reset();
+        registry = std::make_unique<Registry>();
+        registry->AddSystem<TransformBenchmarkSystem>();
+        registry->AddSystem<MoverBenchmarkSystem>();
+        entities = registry->CreateEntities(numEntities);
+        for (auto entity : entities) {
+            registry->AddComponent<TransformComponent>(entity);
+            registry->AddComponent<RigidBodyComponent>(entity);
+        }
+        registry->Update();
+        for (int id : killedIds) {
+            registry->KillEntity(entities[id]);
+        }
+    }, [&]() {
+        registry->Update();
+    });
+    const std::vector<int> transformIds = SortedIds(registry->GetSystem<TransformBenchmarkSystem>().GetSystemEntities());
+    const std::vector<int> moverIds = SortedIds(registry->GetSystem<MoverBenchmarkSystem>().GetSystemEntities());
+    registry.reset();
+
+    std::vector<Entity> systemEntities[2];
+    const double eraseNs = Benchmark::MeasureNsPerOp(1, [&]() {
+        for (auto& system : systemEntities) {
+            system = entities;
+        }
+    }, [&]() {
+        for (int id : killedIds) {
+            for (auto& system : systemEntities) {
+                const Entity killed = entities[id];
+                system.erase(std::remove_if(system.begin(), system.end(), [&killed](Entity other) {
+                    return killed == other;
+                }), system.end());
+            }
+        }
+    });
+
+    const bool isSameResult = transformIds == SortedIds(systemEntities[0]) && moverIds == SortedIds(systemEntities[1]) && static_cast<int>(transformIds.size()) == numEntities - numKilled;
+    std::printf("  erase %9.3f   swap-remove %9.3f   %s\n", eraseNs / 1e6, registryNs / 1e6, isSameResult ? "same entities" : "DIFFERENT ENTITIES");
+    return isSameResult;
+}
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+#include "ColliderScene.h"
+#include "../../2DGameEngine/src/Physics/SpatialHash.h"
+#include "../../2DGameEngine/src/Physics/Narrowphase.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+
+// A battle: 1 player, then 60% enemies, 35% projectiles and 5% inert colliders, gathered in clusters
+// of about 50. With layers, each collider gets the layer and mask the game gives it; without, every
+// collider is in the default layer and collides with everything.
+static ColliderBounds MakeBattle(int numColliders, bool hasLayers) {
+    const int numClusters = std::max(numColliders / 50, 1);
+    std::mt19937 random(29);
+    std::uniform_real_distribution<float> center(0.0f, 600.0f * std::sqrt(static_cast<float>(numClusters)));
+    std::normal_distribution<float> offset(0.0f, 60.0f);
+    std::uniform_real_distribution<float> size(8.0f, 32.0f);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::vector<std::pair<float, float>> centers;
+    for (int i = 0; i < numClusters; i++) {
+        centers.emplace_back(center(random), center(random));
+    }
+
+    ColliderBounds bounds;
+    bounds.Reserve(numColliders);
+    for (int i = 0; i < numColliders; i++) {
+        const auto& cluster = centers[i % numClusters];
+        const float x = cluster.first + offset(random);
+        const float y = cluster.second + offset(random);
+        uint32_t layer = COLLISION_LAYER_PLAYER;
+        uint32_t mask = COLLISION_LAYER_PROJECTILES;
+        if (i > 0) {
+            const int roll = kind(random);
+            if (roll < 60) {
+                layer = COLLISION_LAYER_ENEMIES;
+                mask = COLLISION_LAYER_PROJECTILES | COLLISION_LAYER_OBSTACLES;
+            }
+            else if (roll < 95) {
+                layer = COLLISION_LAYER_PROJECTILES;
+                mask = COLLISION_LAYER_PLAYER | COLLISION_LAYER_ENEMIES;
+            }
+            else {
+                layer = COLLISION_LAYER_DEFAULT;
+                mask = COLLISION_LAYER_NONE;
+            }
+        }
+        if (!hasLayers) {
+            layer = COLLISION_LAYER_DEFAULT;
+            mask = COLLISION_LAYER_ALL;
+        }
+        bounds.Add(x, y, x + size(random), y + size(random), layer, mask);
+    }
+    return bounds;
+}
+
+// The broadphase and narrowphase of the CollisionSystem on the same battle without and with layers.
+// The pairs found with layers must be the pairs found without them whose layers can collide.
+bool RunLayerBenchmark() {
+    std::printf("Collision layers, clustered battle, cells of %.0f, us/frame\n", ColliderScene::CELL_SIZE);
+    std::printf("  %-8s %12s %8s %8s %12s %8s %8s\n", "", "no layers", "pairs", "hits", "layers", "pairs", "hits");
+    bool isSameResult = true;
+    for (int numColliders : { 1000, 10000 }) {
+        double frameNs[2] = {};
+        int numCandidates[2] = {};
+        std::vector<std::pair<int, int>> pairs[2];
+        const ColliderBounds layeredBounds = MakeBattle(numColliders, true);
+        for (bool hasLayers : { false, true }) {
+            const ColliderBounds bounds = MakeBattle(numColliders, hasLayers);
+            SpatialHash spatialHash(ColliderScene::CELL_SIZE);
+            std::vector<std::pair<int, int>> candidatePairs;
+            frameNs[hasLayers] = Benchmark::MeasureNsPerOp(1, [&]() {
+                spatialHash.FindPairs(bounds, candidatePairs);
+                Narrowphase::FilterOverlaps(bounds, candidatePairs, pairs[hasLayers]);
+            });
+            numCandidates[hasLayers] = static_cast<int>(candidatePairs.size());
+        }
+
+        std::vector<std::pair<int, int>> expectedPairs;
+        for (auto& pair : pairs[0]) {
+            if (layeredBounds.CanCollide(pair.first, pair.second)) {
+                expectedPairs.push_back(pair);
+            }
+        }
+        const bool isSamePairs = pairs[1] == expectedPairs;
+        std::printf("  n=%-6d %12.1f %8d %8d %12.1f %8d %8d   %s\n", numColliders, frameNs[0] / 1e3, numCandidates[0], static_cast<int>(pairs[0].size()),
+            frameNs[1] / 1e3, numCandidates[1], static_cast<int>(pairs[1].size()), isSamePairs ? "same pairs" : "DIFFERENT PAIRS");
+        isSameResult = isSameResult && isSamePairs;
+    }
+    return isSameResult;
+}
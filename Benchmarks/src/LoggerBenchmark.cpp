@@ -0,0 +1,93 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/Logger/Logger.h"
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static const int NUM_WRITERS = 4;
+
+// Fewer than Logger::MAX_HISTORY messages per round, so the history holds all of them
+static const int NUM_MESSAGES_PER_WRITER = 250;
+
+// Counts the messages of the round in the logger history
+static int CountRoundMessages(int round) {
+    const std::string prefix = "round " + std::to_string(round) + " ";
+    int numMessages = 0;
+    for (auto& entry : Logger::GetMessages()) {
+        numMessages += entry.message.compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+    }
+    return numMessages;
+}
+
+// Several threads log while the sink thread is stopped under them: every message must still be
+// written, whether it went through the queue before the last drain or straight to the console after.
+// Run it under ThreadSanitizer to check the queue and the shutdown.
+static bool CheckStopWhileWriting() {
+    const int numRounds = 50;
+    int numLostMessages = 0;
+    for (int round = 0; round < numRounds; round++) {
+        Logger::Start();
+        std::atomic<int> numStarted(0);
+        std::vector<std::thread> writers;
+        for (int writer = 0; writer < NUM_WRITERS; writer++) {
+            writers.emplace_back([round, writer, &numStarted]() {
+                numStarted++;
+                for (int i = 0; i < NUM_MESSAGES_PER_WRITER; i++) {
+                    Logger::Log("round ", round, " writer ", writer, " message ", i);
+                }
+            });
+        }
+
+        // Stop at a different point of the writes every round
+        while (numStarted < NUM_WRITERS) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; i < round; i++) {
+            std::this_thread::yield();
+        }
+        Logger::Stop();
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        numLostMessages += NUM_WRITERS * NUM_MESSAGES_PER_WRITER - CountRoundMessages(round);
+    }
+    if (numLostMessages > 0) {
+        std::printf("  %d messages lost while stopping the sink\n", numLostMessages);
+    }
+    return numLostMessages == 0;
+}
+
+// Logger shutdown with writers in flight, then the cost of a message for the calling thread, written
+// right away and pushed to the sink thread. The console output goes to a string in the meantime.
+bool RunLoggerBenchmark() {
+    std::printf("Logger, %d writers, ns/message on the calling thread\n", NUM_WRITERS);
+    std::ostringstream console;
+    std::streambuf* consoleBuffer = std::cout.rdbuf(console.rdbuf());
+    Logger::SetLevel(LOG_INFO);
+
+    const bool isValid = CheckStopWhileWriting();
+
+    const int numMessages = 1000;
+    const double directNs = Benchmark::MeasureNsPerOp(numMessages, [&]() {
+        for (int i = 0; i < numMessages; i++) {
+            Logger::Log("Entity created with id = ", i);
+        }
+    });
+    Logger::Start();
+    const double queuedNs = Benchmark::MeasureNsPerOp(numMessages, [&]() {
+        for (int i = 0; i < numMessages; i++) {
+            Logger::Log("Entity created with id = ", i);
+        }
+    });
+    Logger::Stop();
+
+    Logger::SetLevel(LOG_WARNING);
+    std::cout.rdbuf(consoleBuffer);
+    if (isValid) {
+        std::printf("  no message lost when stopping the sink under %d writers\n", NUM_WRITERS);
+    }
+    std::printf("  direct %8.1f   queued %8.1f\n", directNs, queuedNs);
+    return isValid;
+}
@@ -0,0 +1,77 @@
+#include "../../2DGameEngine/src/Logger/Logger.h"
+#include <cstdio>
+#include <cstring>
+
+// Every benchmark returns false if the code it measured gave a wrong result
+bool RunSparseSetBenchmark();
+bool RunParallelForBenchmark();
+bool RunSignatureBenchmark();
+bool RunSpatialHashBenchmark();
+bool RunNarrowphaseBenchmark();
+bool RunLoggerBenchmark();
+bool RunPackBenchmark();
+bool RunKillBenchmark();
+bool RunBatchBenchmark();
+bool RunGroupBenchmark();
+bool RunAssetBenchmark();
+bool RunPoolBenchmark();
+bool RunPrefabBenchmark();
+bool RunRecycleBenchmark();
+bool RunSnapshotBenchmark();
+bool RunLayerBenchmark();
+
+struct BenchmarkEntry {
+    const char* name;
+    bool (*run)();
+};
+
+static const BenchmarkEntry BENCHMARKS[] = {
+    { "sparse-set", RunSparseSetBenchmark },
+    { "parallel-for", RunParallelForBenchmark },
+    { "signature", RunSignatureBenchmark },
+    { "spatial-hash", RunSpatialHashBenchmark },
+    { "narrowphase", RunNarrowphaseBenchmark },
+    { "logger", RunLoggerBenchmark },
+    { "pack", RunPackBenchmark },
+    { "kill", RunKillBenchmark },
+    { "batch", RunBatchBenchmark },
+    { "group", RunGroupBenchmark },
+    { "asset", RunAssetBenchmark },
+    { "pool", RunPoolBenchmark },
+    { "prefab", RunPrefabBenchmark },
+    { "recycle", RunRecycleBenchmark },
+    { "snapshot", RunSnapshotBenchmark },
+    { "layer", RunLayerBenchmark },
+};
+
+// "Benchmarks" runs every benchmark, "Benchmarks sparse-set ..." only the given ones. Exits with 1
+// if a benchmark found a wrong result.
+int main(int argc, char* argv[]) {
+    // The registries the benchmarks create log every batch, which would bury the results
+    Logger::SetLevel(LOG_WARNING);
+
+    bool isFound = argc == 1;
+    bool isValid = true;
+    for (auto& benchmark : BENCHMARKS) {
+        bool isSelected = argc == 1;
+        for (int i = 1; i < argc; i++) {
+            isSelected = isSelected || std::strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (isSelected) {
+            if (!benchmark.run()) {
+                std::printf("  FAILED: %s gave a wrong result\n", benchmark.name);
+                isValid = false;
+            }
+            std::printf("\n");
+            isFound = true;
+        }
+    }
+    if (!isFound) {
+        std::printf("Unknown benchmark, available benchmarks:\n");
+        for (auto& benchmark : BENCHMARKS) {
+            std::printf("  %s\n", benchmark.name);
+        }
+        return 1;
+    }
+    return isValid ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "Benchmark.h"
+#include "ColliderScene.h"
+#include "../../2DGameEngine/src/Physics/SpatialHash.h"
+#include "../../2DGameEngine/src/Physics/Narrowphase.h"
+
+// The largest number of colliders the CollisionSystem tests without broadphase, kept in sync by hand
+static const int MAX_COLLIDERS_WITHOUT_BROADPHASE = 128;
+
+// Runs func numFrames times per run and returns the fastest frame in nanoseconds
+template <typename TFunc>
+static double MeasureNsPerFrame(int numFrames, TFunc&& func) {
+    return Benchmark::MeasureNsPerOp(numFrames, [&]() {
+        for (int frame = 0; frame < numFrames; frame++) {
+            func();
+        }
+    });
+}
+
+// Every pair tested one at a time and through Narrowphase::FindOverlaps, then the spatial hash followed
+// by Narrowphase::FilterOverlaps, the path of the CollisionSystem above its threshold. The last size
+// where FindOverlaps is still faster than the hash is where the CollisionSystem should switch to the
+// broadphase. Build it with AVX2 enabled to time the AVX2 path.
+bool RunNarrowphaseBenchmark() {
+#if defined(NARROWPHASE_NO_SIMD)
+    const char* path = "scalar";
+#elif defined(__AVX2__)
+    const char* path = "AVX2";
+#else
+    const char* path = "SSE2";
+#endif
+    std::printf("Narrowphase, colliders of 8 to 48 units, one per 100x100 units, us/frame\n");
+    std::printf("  %-8s %12s %12s %12s\n", "", "scalar", path, "hash");
+
+    bool isSameResult = true;
+    int lastFasterOverlaps = 0;
+    for (int numColliders : { 16, 32, 64, 96, 128, 160, 192, 224, 256, 320, 384, 512, 1024 }) {
+        const ColliderBounds bounds = ColliderScene::MakeColliders(numColliders);
+
+        // Enough frames per run that the smallest scenes take a few milliseconds
+        const int numFrames = std::max(10, 2000000 / (numColliders * numColliders / 2 + 1));
+
+        std::vector<std::pair<int, int>> scalarPairs;
+        const double scalarNs = MeasureNsPerFrame(numFrames, [&]() {
+            ColliderScene::FindAllPairs(bounds, scalarPairs);
+        });
+
+        std::vector<std::pair<int, int>> overlapPairs;
+        const double overlapsNs = MeasureNsPerFrame(numFrames, [&]() {
+            Narrowphase::FindOverlaps(bounds, overlapPairs);
+        });
+
+        // The hash is kept between frames, as in the CollisionSystem
+        SpatialHash spatialHash(ColliderScene::CELL_SIZE);
+        std::vector<std::pair<int, int>> candidatePairs;
+        std::vector<std::pair<int, int>> hashPairs;
+        const double hashNs = MeasureNsPerFrame(numFrames, [&]() {
+            spatialHash.FindPairs(bounds, candidatePairs);
+            Narrowphase::FilterOverlaps(bounds, candidatePairs, hashPairs);
+        });
+
+        if (overlapsNs <= hashNs) {
+            lastFasterOverlaps = numColliders;
+        }
+        const bool isSame = overlapPairs == scalarPairs && hashPairs == scalarPairs;
+        std::printf("  n=%-6d %12.2f %12.2f %12.2f   %s\n", numColliders, scalarNs / 1e3, overlapsNs / 1e3, hashNs / 1e3, isSame ? "same pairs" : "DIFFERENT PAIRS");
+        isSameResult = isSameResult && isSame;
+    }
+    std::printf("  %s faster than the hash up to n=%d, the CollisionSystem switches above n=%d\n", path, lastFasterOverlaps, MAX_COLLIDERS_WITHOUT_BROADPHASE);
+    return isSameResult;
+}
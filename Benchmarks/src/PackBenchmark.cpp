@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include <cstring>
+
+// The positions of the movers, so the three ways of moving them can be compared
+static uint64_t Checksum(Registry& registry, const std::vector<Entity>& movers) {
+    uint64_t checksum = 0;
+    for (auto mover : movers) {
+        const auto& transform = registry.GetComponent<TransformComponent>(mover);
+        uint32_t x, y;
+        std::memcpy(&x, &transform.position.x, sizeof(x));
+        std::memcpy(&y, &transform.position.y, sizeof(y));
+        checksum = checksum * 31 + x * 7 + y;
+    }
+    return checksum;
+}
+
+// Half of the entities move, with their ids shuffled so the pools are not in id order. Returns the
+// movers in creation order.
+static std::vector<Entity> CreateMovers(Registry& registry, int numEntities) {
+    const std::vector<Entity> entities = registry.CreateEntities(numEntities);
+    std::vector<Entity> movers;
+    for (int id : Benchmark::ShuffledIds(numEntities)) {
+        registry.AddComponent<TransformComponent>(entities[id], glm::vec2(static_cast<float>(id % 100), static_cast<float>(id / 100)));
+        if (id % 2 == 0) {
+            registry.AddComponent<RigidBodyComponent>(entities[id], glm::vec2(static_cast<float>(id % 7) - 3.0f, 1.0f));
+            movers.push_back(entities[id]);
+        }
+    }
+    registry.Update();
+    return movers;
+}
+
+// MovementSystem-style update of the Transform/RigidBody entities: one GetComponent per component
+// and entity as the systems did before the views, then a view over the pools, then a view over the
+// Transform/RigidBody pack that the game registers
+bool RunPackBenchmark() {
+    const int numEntities = 20000;
+    const int numFrames = 100;
+    const float deltaTime = 1.0f / 60.0f;
+    std::printf("Component pack, %d movers among %d entities, us/frame\n", numEntities / 2, numEntities);
+
+    uint64_t checksums[3] = {};
+    double frameNs[3] = {};
+    for (int mode = 0; mode < 3; mode++) {
+        std::unique_ptr<Registry> registry;
+        std::vector<Entity> movers;
+        frameNs[mode] = Benchmark::MeasureNsPerOp(numFrames, [&]() {
+            registry.reset();
+            registry = std::make_unique<Registry>();
+            if (mode == 2) {
+                registry->AddPack<TransformComponent, RigidBodyComponent>();
+            }
+            movers = CreateMovers(*registry, numEntities);
+        }, [&]() {
+            for (int frame = 0; frame < numFrames; frame++) {
+                if (mode == 0) {
+                    for (auto mover : movers) {
+                        auto& transform = registry->GetComponent<TransformComponent>(mover);
+                        const auto& rigidBody = registry->GetComponent<RigidBodyComponent>(mover);
+                        transform.position += rigidBody.velocity * deltaTime;
+                    }
+                    continue;
+                }
+                registry->View<TransformComponent, RigidBodyComponent>().Each([deltaTime](Entity, TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+                    transform.position += rigidBody.velocity * deltaTime;
+                });
+            }
+        });
+        checksums[mode] = Checksum(*registry, movers);
+        registry.reset();
+    }
+
+    std::printf("  GetComponent %8.1f   view %8.1f   packed view %8.1f   %s\n", frameNs[0] / 1e3, frameNs[1] / 1e3, frameNs[2] / 1e3,
+        checksums[1] == checksums[0] && checksums[2] == checksums[0] ? "same positions" : "DIFFERENT POSITIONS");
+    return checksums[1] == checksums[0] && checksums[2] == checksums[0];
+}
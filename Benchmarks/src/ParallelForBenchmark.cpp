@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Scheduler/ThreadPool.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include <cstring>
+#include <thread>
+
+// The chunk size used by the MovementSystem
+static const int CHUNK_SIZE = 1024;
+
+// Moves the packed Transform/RigidBody range like the MovementSystem does, and returns a checksum of
+// the final positions so the runs with different thread counts can be compared
+static uint64_t MoveEntities(Registry& registry, ThreadPool& threadPool, int numFrames) {
+    const double deltaTime = 1.0 / 60.0;
+    auto view = registry.View<TransformComponent, RigidBodyComponent>();
+    auto move = [deltaTime](Entity, TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+        transform.position.x += rigidBody.velocity.x * static_cast<float>(deltaTime);
+        transform.position.y += rigidBody.velocity.y * static_cast<float>(deltaTime);
+    };
+    for (int frame = 0; frame < numFrames; frame++) {
+        threadPool.ParallelFor(view.GetSize(), CHUNK_SIZE, [&view, &move](int begin, int end) {
+            view.Each(move, begin, end);
+        });
+    }
+
+    uint64_t checksum = 0;
+    view.Each([&checksum](Entity, const TransformComponent& transform, const RigidBodyComponent&) {
+        uint32_t x, y;
+        std::memcpy(&x, &transform.position.x, sizeof(x));
+        std::memcpy(&y, &transform.position.y, sizeof(y));
+        checksum = checksum * 31 + x * 7 + y;
+    });
+    return checksum;
+}
+
+// MovementSystem-style update of packed movers split in chunks, for several worker counts. On a
+// single core the workers can only add scheduling overhead, so the speedup needs several cores.
+bool RunParallelForBenchmark() {
+    const int numEntities = 100000;
+    const int numFrames = 100;
+    const int numCores = static_cast<int>(std::thread::hardware_concurrency());
+    std::printf("ParallelFor, %d packed movers, chunks of %d, %d hardware threads, ms/frame\n", numEntities, CHUNK_SIZE, numCores);
+
+    std::vector<int> workerCounts = { 0, 1, 2, 4, 8 };
+    if (numCores - 1 > 8) {
+        workerCounts.push_back(numCores - 1);
+    }
+
+    double inlineMs = 0.0;
+    uint64_t inlineChecksum = 0;
+    bool isSameResult = true;
+    for (int numWorkers : workerCounts) {
+        ThreadPool threadPool(numWorkers);
+        uint64_t checksum = 0;
+
+        // Every run starts from the same positions
+        std::unique_ptr<Registry> registry;
+        const double ns = Benchmark::MeasureNsPerOp(numFrames, [&]() {
+            registry.reset();
+            registry = std::make_unique<Registry>();
+            registry->AddPack<TransformComponent, RigidBodyComponent>();
+            std::vector<TransformComponent> transforms;
+            std::vector<RigidBodyComponent> rigidBodies;
+            for (int i = 0; i < numEntities; i++) {
+                transforms.emplace_back(glm::vec2(static_cast<float>(i % 1000), static_cast<float>(i / 1000)));
+                rigidBodies.emplace_back(glm::vec2(static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) - 2.0f));
+            }
+            const std::vector<Entity> entities = registry->CreateEntities(numEntities);
+            registry->AddComponents(entities, transforms);
+            registry->AddComponents(entities, rigidBodies);
+            registry->Update();
+        }, [&]() {
+            checksum = MoveEntities(*registry, threadPool, numFrames);
+        });
+        registry.reset();
+
+        const double ms = ns / 1e6;
+        if (numWorkers == 0) {
+            inlineMs = ms;
+            inlineChecksum = checksum;
+        }
+        std::printf("  %d workers   %7.3f ms   x%.2f   %s\n", numWorkers, ms, inlineMs / ms, checksum == inlineChecksum ? "same result" : "DIFFERENT RESULT");
+        isSameResult = isSameResult && checksum == inlineChecksum;
+    }
+    return isSameResult;
+}
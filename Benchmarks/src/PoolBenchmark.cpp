@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/ECS/MemoryArena.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+
+// Bytes reserved by all the pools of the registry
+static size_t GetReservedBytes(const Registry& registry) {
+    size_t reservedBytes = 0;
+    for (auto& stats : registry.GetPoolStats()) {
+        reservedBytes += stats.reservedBytes;
+    }
+    return reservedBytes;
+}
+
+// Two pools of 20000 components loaded one entity at a time into a PageArena registry, with the pools
+// growing on their own and reserved up front as the pool_capacity table of a level does. Killing every
+// entity and trimming must give all the memory back.
+bool RunPoolBenchmark() {
+    const int numEntities = 20000;
+    std::printf("Component pools, %d Transform and BoxCollider components in a PageArena\n", numEntities);
+
+    bool isValid = true;
+    for (bool hasCapacityHint : { false, true }) {
+        std::unique_ptr<Registry> registry;
+        std::unique_ptr<PageArena> pageArena;
+        const double loadNs = Benchmark::MeasureNsPerOp(1, [&]() {
+            registry.reset();
+            pageArena = std::make_unique<PageArena>();
+            registry = std::make_unique<Registry>(*pageArena);
+        }, [&]() {
+            if (hasCapacityHint) {
+                registry->ReserveComponents<TransformComponent>(numEntities);
+                registry->ReserveComponents<BoxColliderComponent>(numEntities);
+            }
+            for (int i = 0; i < numEntities; i++) {
+                const Entity entity = registry->CreateEntity();
+                registry->AddComponent<TransformComponent>(entity, glm::vec2(static_cast<float>(i % 256), static_cast<float>(i / 256)));
+                registry->AddComponent<BoxColliderComponent>(entity, 32, 32);
+            }
+            registry->Update();
+        });
+
+        const size_t loadedBytes = GetReservedBytes(*registry);
+        registry->TrimPools();
+        const size_t trimmedBytes = GetReservedBytes(*registry);
+
+        for (int id = 0; id < numEntities; id++) {
+            registry->KillEntity(registry->GetEntity(id));
+        }
+        registry->Update();
+        registry->TrimPools();
+        const bool isEmptied = GetReservedBytes(*registry) == 0 && pageArena->GetReservedBytes() == 0;
+        registry.reset();
+
+        std::printf("  %-8s %7.3f ms load   %5.2f MB reserved   %5.2f MB after trim   %s\n", hasCapacityHint ? "hint" : "no hint", loadNs / 1e6, loadedBytes / 1e6, trimmedBytes / 1e6,
+            isEmptied ? "0 bytes once emptied" : "MEMORY LEFT ONCE EMPTIED");
+        isValid = isValid && isEmptied;
+    }
+    return isValid;
+}
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/ECS/Prefab.h"
+#include "../../2DGameEngine/src/ECS/CommandBuffer.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+#include "../../2DGameEngine/src/Components/HealthComponent.h"
+
+// Per-shot values, the rest of the components is the same for every projectile
+static glm::vec2 GetSpawnPosition(int i) {
+    return glm::vec2(static_cast<float>(i % 256), static_cast<float>(i / 256));
+}
+
+static glm::vec2 GetSpawnVelocity(int i) {
+    return glm::vec2(static_cast<float>(i % 7) - 3.0f, 1.0f);
+}
+
+// Components and group of every entity, so the spawning modes can be compared
+static std::vector<int> GetSpawnedEntities(Registry& registry, int numSpawns) {
+    const int projectilesId = Registry::GetGroupId("projectiles");
+    std::vector<int> values;
+    for (int id = 0; id < numSpawns; id++) {
+        const Entity entity = registry.GetEntity(id);
+        const auto& transform = registry.GetComponent<TransformComponent>(entity);
+        const auto& rigidBody = registry.GetComponent<RigidBodyComponent>(entity);
+        values.push_back(static_cast<int>(transform.position.x) + static_cast<int>(transform.position.y) * 256);
+        values.push_back(static_cast<int>(rigidBody.velocity.x));
+        values.push_back(registry.GetComponent<BoxColliderComponent>(entity).width);
+        values.push_back(registry.GetComponent<HealthComponent>(entity).healthPercentage);
+        values.push_back(registry.EntityBelongsToGroup(entity, projectilesId));
+    }
+    return values;
+}
+
+// Projectile spawns with four components and a group, component by component and from a prefab that
+// only gets the per-shot transform and velocity, both directly and through a command buffer. The
+// Update() that applies the spawns is timed with them.
+bool RunPrefabBenchmark() {
+    const int numSpawns = 10000;
+    std::printf("Prefab, %d spawns with 4 components and a group, ms/wave\n", numSpawns);
+    const char* modeNames[] = { "AddComponent", "Instantiate", "buffered AddComponent", "buffered Instantiate" };
+
+    std::vector<int> results[4];
+    double waveNs[4] = {};
+    for (int mode = 0; mode < 4; mode++) {
+        std::unique_ptr<Registry> registry;
+        Prefab* prefab = nullptr;
+        CommandBuffer* commandBuffer = nullptr;
+        waveNs[mode] = Benchmark::MeasureNsPerOp(1, [&]() {
+            registry.reset();
+            registry = std::make_unique<Registry>();
+            prefab = &registry->CreatePrefab("projectile");
+            prefab->AddComponent<TransformComponent>();
+            prefab->AddComponent<RigidBodyComponent>();
+            prefab->AddComponent<BoxColliderComponent>(4, 4);
+            prefab->AddComponent<HealthComponent>(100);
+            prefab->Group("projectiles");
+            commandBuffer = &registry->CreateCommandBuffer();
+        }, [&]() {
+            if (mode == 0) {
+                for (int i = 0; i < numSpawns; i++) {
+                    const Entity projectile = registry->CreateEntity();
+                    registry->AddComponent<TransformComponent>(projectile, GetSpawnPosition(i));
+                    registry->AddComponent<RigidBodyComponent>(projectile, GetSpawnVelocity(i));
+                    registry->AddComponent<BoxColliderComponent>(projectile, 4, 4);
+                    registry->AddComponent<HealthComponent>(projectile, 100);
+                    registry->GroupEntity(projectile, "projectiles");
+                }
+            }
+            else if (mode == 1) {
+                const std::vector<Entity> projectiles = registry->Instantiate(*prefab, numSpawns);
+                for (int i = 0; i < numSpawns; i++) {
+                    registry->GetComponent<TransformComponent>(projectiles[i]).position = GetSpawnPosition(i);
+                    registry->GetComponent<RigidBodyComponent>(projectiles[i]).velocity = GetSpawnVelocity(i);
+                }
+            }
+            else if (mode == 2) {
+                for (int i = 0; i < numSpawns; i++) {
+                    const PendingEntity projectile = commandBuffer->CreateEntity();
+                    commandBuffer->AddComponent<TransformComponent>(projectile, GetSpawnPosition(i));
+                    commandBuffer->AddComponent<RigidBodyComponent>(projectile, GetSpawnVelocity(i));
+                    commandBuffer->AddComponent<BoxColliderComponent>(projectile, 4, 4);
+                    commandBuffer->AddComponent<HealthComponent>(projectile, 100);
+                    commandBuffer->GroupEntity(projectile, "projectiles");
+                }
+            }
+            else {
+                for (int i = 0; i < numSpawns; i++) {
+                    const PendingEntity projectile = commandBuffer->Instantiate(*prefab);
+                    commandBuffer->AddComponent<TransformComponent>(projectile, GetSpawnPosition(i));
+                    commandBuffer->AddComponent<RigidBodyComponent>(projectile, GetSpawnVelocity(i));
+                }
+            }
+            registry->Update();
+        });
+        results[mode] = GetSpawnedEntities(*registry, numSpawns);
+        registry.reset();
+    }
+
+    bool isSameResult = true;
+    for (int mode = 0; mode < 4; mode++) {
+        std::printf("  %-22s %7.3f   %s\n", modeNames[mode], waveNs[mode] / 1e6, results[mode] == results[0] ? "same entities" : "DIFFERENT ENTITIES");
+        isSameResult = isSameResult && results[mode] == results[0];
+    }
+    return isSameResult;
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/ECS/Prefab.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+#include "../../2DGameEngine/src/Components/HealthComponent.h"
+#include <deque>
+
+// Spawns projectiles from the prefab, with the per-shot transform and velocity of the spawn number
+static void SpawnProjectiles(Registry& registry, const Prefab& prefab, int count, int& numSpawned, std::deque<Entity>& projectiles) {
+    for (auto projectile : registry.Instantiate(prefab, count)) {
+        registry.GetComponent<TransformComponent>(projectile).position = glm::vec2(static_cast<float>(numSpawned % 256), static_cast<float>(numSpawned / 256));
+        registry.GetComponent<RigidBodyComponent>(projectile).velocity = glm::vec2(static_cast<float>(numSpawned % 7) - 3.0f, 1.0f);
+        projectiles.push_back(projectile);
+        numSpawned++;
+    }
+}
+
+// Steady wave of projectiles: every frame the oldest ones die and as many new ones are spawned from
+// the prefab, with and without recycling. Both must end up with the same live projectiles, whatever
+// their entity ids.
+bool RunRecycleBenchmark() {
+    const int numLive = 2000;
+    const int numSpawnsPerFrame = 200;
+    const int numFrames = 100;
+    std::printf("Recycling, %d live projectiles, %d spawned and killed per frame, us/frame\n", numLive, numSpawnsPerFrame);
+
+    std::vector<int> results[2];
+    double frameNs[2] = {};
+    for (bool isRecycling : { false, true }) {
+        std::unique_ptr<Registry> registry;
+        Prefab* prefab = nullptr;
+        std::deque<Entity> projectiles;
+        int numSpawned = 0;
+        frameNs[isRecycling] = Benchmark::MeasureNsPerOp(numFrames, [&]() {
+            registry.reset();
+            registry = std::make_unique<Registry>();
+            prefab = &registry->CreatePrefab("projectile");
+            prefab->AddComponent<TransformComponent>();
+            prefab->AddComponent<RigidBodyComponent>();
+            prefab->AddComponent<BoxColliderComponent>(4, 4);
+            prefab->AddComponent<HealthComponent>(100);
+            prefab->Group("projectiles");
+            prefab->SetRecycling(isRecycling);
+            projectiles.clear();
+            numSpawned = 0;
+            SpawnProjectiles(*registry, *prefab, numLive, numSpawned, projectiles);
+            registry->Update();
+        }, [&]() {
+            for (int frame = 0; frame < numFrames; frame++) {
+                for (int i = 0; i < numSpawnsPerFrame; i++) {
+                    registry->KillEntity(projectiles.front());
+                    projectiles.pop_front();
+                }
+                SpawnProjectiles(*registry, *prefab, numSpawnsPerFrame, numSpawned, projectiles);
+                registry->Update();
+            }
+        });
+
+        // Sorted spawn positions of the live projectiles
+        registry->View<TransformComponent, RigidBodyComponent, BoxColliderComponent, HealthComponent>().Each([&](Entity, const TransformComponent& transform, const RigidBodyComponent&, const BoxColliderComponent&, const HealthComponent&) {
+            results[isRecycling].push_back(static_cast<int>(transform.position.x) + static_cast<int>(transform.position.y) * 256);
+        });
+        std::sort(results[isRecycling].begin(), results[isRecycling].end());
+        registry.reset();
+    }
+
+    const bool isSameResult = results[1] == results[0] && static_cast<int>(results[0].size()) == numLive;
+    std::printf("  no recycling %7.1f   recycling %7.1f   %s\n", frameNs[0] / 1e3, frameNs[1] / 1e3, isSameResult ? "same projectiles" : "DIFFERENT PROJECTILES");
+    return isSameResult;
+}
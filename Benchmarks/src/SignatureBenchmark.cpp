@@ -0,0 +1,117 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/Signature.h"
+#include <bitset>
+
+using ScalarSignature = std::bitset<Signature::NUM_BITS>;
+
+// Random signatures with about one bit in bitDensity set, kept in both representations
+static void MakeSignatures(int count, int bitDensity, std::mt19937& random, std::vector<Signature>& signatures, std::vector<ScalarSignature>& scalarSignatures) {
+    signatures.assign(count, Signature());
+    scalarSignatures.assign(count, ScalarSignature());
+    for (int i = 0; i < count; i++) {
+        for (size_t bit = 0; bit < Signature::NUM_BITS; bit++) {
+            if (random() % bitDensity == 0) {
+                signatures[i].set(bit);
+                scalarSignatures[i].set(bit);
+            }
+        }
+    }
+}
+
+static bool IsSame(const Signature& signature, const ScalarSignature& scalarSignature) {
+    for (size_t bit = 0; bit < Signature::NUM_BITS; bit++) {
+        if (signature.test(bit) != scalarSignature.test(bit)) {
+            return false;
+        }
+    }
+    return signature.any() == scalarSignature.any() && signature.none() == scalarSignature.none();
+}
+
+// Every Signature operation against std::bitset, on dense, sparse and empty signatures
+static bool CheckSignatures() {
+    std::mt19937 random(7);
+    std::vector<Signature> signatures;
+    std::vector<ScalarSignature> scalarSignatures;
+    int numErrors = 0;
+    for (int bitDensity : { 2, 16, 1000000 }) {
+        MakeSignatures(64, bitDensity, random, signatures, scalarSignatures);
+
+        // Pairs where b is a subset of a, so Contains is also checked when it is true
+        for (int i = 0; i < 32; i++) {
+            signatures.push_back(signatures[i] & signatures[i + 1]);
+            scalarSignatures.push_back(scalarSignatures[i] & scalarSignatures[i + 1]);
+        }
+
+        for (size_t i = 0; i < signatures.size(); i++) {
+            for (size_t j = 0; j < signatures.size(); j++) {
+                const Signature& a = signatures[i];
+                const Signature& b = signatures[j];
+                const ScalarSignature& scalarA = scalarSignatures[i];
+                const ScalarSignature& scalarB = scalarSignatures[j];
+                const bool isValid =
+                    a.Contains(b) == ((scalarA & scalarB) == scalarB) &&
+                    a.Intersects(b) == (scalarA & scalarB).any() &&
+                    (a == b) == (scalarA == scalarB) &&
+                    (a != b) == (scalarA != scalarB) &&
+                    IsSame(a & b, scalarA & scalarB) &&
+                    IsSame(a | b, scalarA | scalarB) &&
+                    IsSame(a ^ b, scalarA ^ scalarB);
+                numErrors += isValid ? 0 : 1;
+            }
+
+            Signature cleared = signatures[i];
+            cleared.set(i % Signature::NUM_BITS, false);
+            ScalarSignature scalarCleared = scalarSignatures[i];
+            scalarCleared.set(i % Signature::NUM_BITS, false);
+            numErrors += IsSame(cleared, scalarCleared) && IsSame(cleared.reset(), scalarCleared.reset()) ? 0 : 1;
+        }
+    }
+    if (numErrors > 0) {
+        std::printf("  %d Signature results differ from std::bitset\n", numErrors);
+    }
+    return numErrors == 0;
+}
+
+// Signature matches checked against std::bitset, then timed against it. Build with
+// SIGNATURE_BITS=128 or 256 (and with AVX2 enabled) to check the other widths and paths.
+bool RunSignatureBenchmark() {
+#if defined(SIGNATURE_USE_AVX2)
+    const char* path = "AVX2";
+#elif defined(SIGNATURE_USE_SSE2)
+    const char* path = "SSE2";
+#else
+    const char* path = "scalar";
+#endif
+    std::printf("Signature, %d bits (%s), ns/match\n", static_cast<int>(Signature::NUM_BITS), path);
+    if (!CheckSignatures()) {
+        return false;
+    }
+    std::printf("  every operation matches std::bitset\n");
+
+    // Matches of entity signatures against a system signature, as in Registry::AddEntityToSystems
+    const int numEntities = 100000;
+    std::mt19937 random(11);
+    std::vector<Signature> signatures;
+    std::vector<ScalarSignature> scalarSignatures;
+    MakeSignatures(numEntities, 4, random, signatures, scalarSignatures);
+    Signature systemSignature;
+    systemSignature.set(0).set(Signature::NUM_BITS - 1);
+    const ScalarSignature scalarSystemSignature = ScalarSignature().set(0).set(Signature::NUM_BITS - 1);
+
+    int numMatches = 0;
+    const double bitsetNs = Benchmark::MeasureNsPerOp(numEntities, [&]() {
+        numMatches = 0;
+        for (auto& signature : scalarSignatures) {
+            numMatches += (signature & scalarSystemSignature) == scalarSystemSignature ? 1 : 0;
+        }
+    });
+    const int numScalarMatches = numMatches;
+    const double signatureNs = Benchmark::MeasureNsPerOp(numEntities, [&]() {
+        numMatches = 0;
+        for (auto& signature : signatures) {
+            numMatches += signature.Contains(systemSignature) ? 1 : 0;
+        }
+    });
+    std::printf("  std::bitset %6.2f   Signature::Contains %6.2f   (%d matches)\n", bitsetNs, signatureNs, numMatches);
+    return numMatches == numScalarMatches;
+}
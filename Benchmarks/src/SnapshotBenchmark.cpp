@@ -0,0 +1,89 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include "../../2DGameEngine/src/Components/RigidBodyComponent.h"
+#include "../../2DGameEngine/src/Components/BoxColliderComponent.h"
+#include "../../2DGameEngine/src/Components/HealthComponent.h"
+#include <cstdio>
+
+static const char* SNAPSHOT_FILE_PATH = "./snapshot-benchmark.snapshot";
+
+// Handle, components, tag and group of every entity id, so the saved and loaded registries can be compared
+static std::vector<int> GetEntityRecords(Registry& registry, int numEntities) {
+    const int playerId = Registry::GetTagId("player");
+    const int enemiesId = Registry::GetGroupId("enemies");
+    std::vector<int> records;
+    for (int id = 0; id < numEntities; id++) {
+        const Entity entity = registry.GetEntity(id);
+        records.push_back(registry.IsEntityAlive(entity) ? entity.GetGeneration() : -1);
+        if (!registry.IsEntityAlive(entity)) {
+            continue;
+        }
+        const auto& transform = registry.GetComponent<TransformComponent>(entity);
+        records.push_back(static_cast<int>(transform.position.x) + static_cast<int>(transform.position.y) * 1000);
+        records.push_back(registry.HasComponent<RigidBodyComponent>(entity) ? static_cast<int>(registry.GetComponent<RigidBodyComponent>(entity).velocity.x) : 99);
+        records.push_back(registry.HasComponent<BoxColliderComponent>(entity) ? registry.GetComponent<BoxColliderComponent>(entity).width : -1);
+        records.push_back(registry.HasComponent<HealthComponent>(entity) ? registry.GetComponent<HealthComponent>(entity).healthPercentage : -1);
+        records.push_back(registry.EntityHasTag(entity, playerId));
+        records.push_back(registry.EntityBelongsToGroup(entity, enemiesId));
+    }
+    return records;
+}
+
+// Round trip of 100000 entities through a snapshot file, which is read back through a memory mapping.
+// Every tenth entity is killed and created again before saving, so the generations are not all 0.
+// The loaded registry must hold the same entities, components, tags and groups.
+bool RunSnapshotBenchmark() {
+    const int numEntities = 100000;
+    std::printf("Snapshot, %d entities saved to a file and loaded through a memory mapping, ms\n", numEntities);
+
+    std::vector<int> savedRecords;
+    double saveNs = 0.0;
+    {
+        Registry registry;
+        std::vector<Entity> entities = registry.CreateEntities(numEntities);
+        for (int id = 0; id < numEntities; id += 10) {
+            registry.KillEntity(entities[id]);
+        }
+        registry.Update();
+        for (int id = 0; id < numEntities; id += 10) {
+            entities[id] = registry.CreateEntity();
+        }
+        for (int id : Benchmark::ShuffledIds(numEntities)) {
+            const Entity entity = registry.GetEntity(id);
+            registry.AddComponent<TransformComponent>(entity, glm::vec2(static_cast<float>(id % 1000), static_cast<float>(id / 1000)));
+            if (id % 2 == 0) {
+                registry.AddComponent<RigidBodyComponent>(entity, glm::vec2(static_cast<float>(id % 7) - 3.0f, 1.0f));
+            }
+            if (id % 3 == 0) {
+                registry.AddComponent<BoxColliderComponent>(entity, id % 64, 32);
+                registry.AddComponent<HealthComponent>(entity, id % 100);
+                registry.GroupEntity(entity, "enemies");
+            }
+        }
+        registry.TagEntity(registry.GetEntity(0), "player");
+        registry.Update();
+
+        saveNs = Benchmark::MeasureNsPerOp(1, [&]() {
+            registry.SaveSnapshot(SNAPSHOT_FILE_PATH);
+        });
+        savedRecords = GetEntityRecords(registry, numEntities);
+    }
+
+    std::vector<int> loadedRecords;
+    bool isLoaded = true;
+    double loadNs = 0.0;
+    {
+        Registry registry;
+        registry.RegisterComponents<TransformComponent, RigidBodyComponent, BoxColliderComponent, HealthComponent>();
+        loadNs = Benchmark::MeasureNsPerOp(1, [&]() {
+            isLoaded = registry.LoadSnapshot(SNAPSHOT_FILE_PATH) && isLoaded;
+        });
+        loadedRecords = GetEntityRecords(registry, numEntities);
+    }
+    std::remove(SNAPSHOT_FILE_PATH);
+
+    const bool isSameResult = isLoaded && loadedRecords == savedRecords;
+    std::printf("  save %7.3f   load %7.3f   %s\n", saveNs / 1e6, loadNs / 1e6, isSameResult ? "same entities" : "DIFFERENT ENTITIES");
+    return isSameResult;
+}
@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "../../2DGameEngine/src/ECS/ECS.h"
+#include "../../2DGameEngine/src/Components/TransformComponent.h"
+#include <unordered_map>
+
+// The component pool before the paged sparse set: a vector indexed through two hash maps
+template <typename T>
+class HashMapPool {
+private:
+    std::vector<T> data;
+    int size = 0;
+    std::unordered_map<int, int> entityIdToIndex;
+    std::unordered_map<int, int> indexToEntityId;
+
+public:
+    HashMapPool(int capacity = 100) {
+        data.resize(capacity);
+    }
+
+    void Set(int entityId, T object) {
+        if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
+            data[entityIdToIndex[entityId]] = object;
+            return;
+        }
+        const int index = size;
+        entityIdToIndex.emplace(entityId, index);
+        indexToEntityId.emplace(index, entityId);
+        if (index >= static_cast<int>(data.size())) {
+            data.resize(size * 2);
+        }
+        data[index] = object;
+        size++;
+    }
+
+    void Remove(int entityId) {
+        const int indexOfRemoved = entityIdToIndex[entityId];
+        const int indexOfLast = size - 1;
+        data[indexOfRemoved] = data[indexOfLast];
+        const int entityIdOfLastElement = indexToEntityId[indexOfLast];
+        entityIdToIndex[entityIdOfLastElement] = indexOfRemoved;
+        indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
+        entityIdToIndex.erase(entityId);
+        indexToEntityId.erase(indexOfLast);
+        size--;
+    }
+
+    T& Get(int entityId) {
+        return data[entityIdToIndex[entityId]];
+    }
+};
+
+// Set, Get and Remove of n components in a shuffled entity id order, so the lookups do not
+// walk the memory in order
+template <typename TPool>
+static void MeasurePool(const char* name, int n) {
+    const std::vector<int> ids = Benchmark::ShuffledIds(n);
+    std::unique_ptr<TPool> pool;
+
+    const double setNs = Benchmark::MeasureNsPerOp(n, [&]() { pool = std::make_unique<TPool>(); }, [&]() {
+        for (int id : ids) {
+            pool->Set(id, TransformComponent(glm::vec2(static_cast<float>(id), 0.0f)));
+        }
+    });
+    const double getNs = Benchmark::MeasureNsPerOp(n, [&]() {
+        uint64_t sum = 0;
+        for (int id : ids) {
+            sum += static_cast<uint64_t>(pool->Get(id).position.x);
+        }
+        Benchmark::Consume(sum);
+    });
+    const double removeNs = Benchmark::MeasureNsPerOp(n, [&]() {
+        pool = std::make_unique<TPool>();
+        for (int id : ids) {
+            pool->Set(id, TransformComponent());
+        }
+    }, [&]() {
+        for (int id : ids) {
+            pool->Remove(id);
+        }
+    });
+
+    std::printf("  %-12s n=%-7d %8.1f %8.1f %8.1f\n", name, n, setNs, getNs, removeNs);
+}
+
+// Component pool lookups, before (hash maps) and after (paged sparse set)
+bool RunSparseSetBenchmark() {
+    std::printf("Component pool, %d-byte component, ns/op\n", static_cast<int>(sizeof(TransformComponent)));
+    std::printf("  %-12s %-9s %8s %8s %8s\n", "pool", "", "Set", "Get", "Remove");
+    for (int n : { 1000, 5000, 50000 }) {
+        MeasurePool<HashMapPool<TransformComponent>>("hash map", n);
+        MeasurePool<Pool<TransformComponent>>("sparse set", n);
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#include "Benchmark.h"
+#include "ColliderScene.h"
+#include "../../2DGameEngine/src/Physics/SpatialHash.h"
+#include "../../2DGameEngine/src/Physics/Narrowphase.h"
+
+// Colliding pairs of a frame at a constant density, tested pair by pair and through the spatial hash.
+// Both must find the same pairs in the same order.
+bool RunSpatialHashBenchmark() {
+    std::printf("Spatial hash, colliders of 8 to 48 units, one per 100x100 units, cells of %.0f, ms/frame\n", ColliderScene::CELL_SIZE);
+    std::printf("  %-8s %12s %12s %8s\n", "", "all pairs", "hash", "pairs");
+    bool isSameResult = true;
+    for (int numColliders : { 1000, 10000, 50000 }) {
+        const ColliderBounds bounds = ColliderScene::MakeColliders(numColliders);
+        std::vector<std::pair<int, int>> allPairs;
+        const double allPairsNs = Benchmark::MeasureNsPerOp(1, [&]() {
+            ColliderScene::FindAllPairs(bounds, allPairs);
+        });
+
+        SpatialHash spatialHash(ColliderScene::CELL_SIZE);
+        std::vector<std::pair<int, int>> candidatePairs;
+        std::vector<std::pair<int, int>> hashPairs;
+        const double hashNs = Benchmark::MeasureNsPerOp(1, [&]() {
+            spatialHash.FindPairs(bounds, candidatePairs);
+            Narrowphase::FilterOverlaps(bounds, candidatePairs, hashPairs);
+        });
+
+        std::printf("  n=%-6d %12.3f %12.3f %8d   %s\n", numColliders, allPairsNs / 1e6, hashNs / 1e6, static_cast<int>(allPairs.size()), hashPairs == allPairs ? "same pairs" : "DIFFERENT PAIRS");
+        isSameResult = isSameResult && hashPairs == allPairs;
+    }
+    return isSameResult;
+}